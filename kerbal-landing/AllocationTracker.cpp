@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "AllocationTracker.h"
+
+static thread_local AllocationSubsystem t_subsystem = ALLOC_OTHER;
+
+static const char* const SUBSYSTEM_NAMES[ALLOC_SUBSYSTEM_COUNT] = {
+    "other", "entities", "sequences", "textures", "terrain", "particles", "shaders",
+    "level", "rendering", "hot reload", "recording", "jobs", "profiler", "telemetry",
+};
+
+AllocationSubsystem AllocationTracker::set_subsystem(AllocationSubsystem subsystem)
+{
+    AllocationSubsystem previous = t_subsystem;
+    t_subsystem = subsystem;
+    return previous;
+}
+
+const char* AllocationTracker::get_subsystem_name(AllocationSubsystem subsystem)
+{
+    return SUBSYSTEM_NAMES[subsystem];
+}
+
+#ifdef KERBAL_TRACK_ALLOCATIONS
+
+// ————— ACCOUNTING ————— //
+// fixed arrays of atomics, since nothing in here may itself allocate
+
+struct SubsystemCounters
+{
+    std::atomic<int64_t> live_bytes{ 0 };
+    std::atomic<int64_t> live_count{ 0 };
+    std::atomic<int64_t> peak_bytes{ 0 };
+    std::atomic<int64_t> total_count{ 0 };
+};
+
+static SubsystemCounters    s_subsystems[ALLOC_SUBSYSTEM_COUNT];
+static SubsystemCounters    s_total;
+static std::atomic<int64_t> s_frame_allocations{ 0 };
+
+// end_frame()'s thread only
+static int64_t s_frames = 0;
+static int64_t s_frame_allocations_total = 0;
+static int64_t s_frame_allocations_max = 0;
+
+// right in front of every block handed out
+struct alignas(16) AllocationHeader
+{
+    uint64_t size;
+    uint32_t subsystem;
+    uint32_t offset;   // from the start of what malloc() returned
+};
+static_assert(sizeof(AllocationHeader) == alignof(AllocationHeader), "the header must sit in one alignment step below the block");
+
+static void raise_peak(std::atomic<int64_t>& peak, int64_t value)
+{
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current and !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+static void count(SubsystemCounters& counters, int64_t bytes, int64_t blocks)
+{
+    int64_t live = counters.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counters.live_count.fetch_add(blocks, std::memory_order_relaxed);
+    if (blocks > 0)
+    {
+        counters.total_count.fetch_add(1, std::memory_order_relaxed);
+        raise_peak(counters.peak_bytes, live);
+    }
+}
+
+static void* allocate_tracked(size_t size, size_t alignment)
+{
+    if (alignment < alignof(AllocationHeader)) alignment = alignof(AllocationHeader);
+
+    // room for the header, and to slide the block up to the alignment from wherever malloc() lands
+    // (only 8-byte aligned on 32-bit MSVC, so no alignment can be assumed of it)
+    unsigned char* raw = (unsigned char*)malloc(size + sizeof(AllocationHeader) + alignment - 1);
+    if (raw == nullptr) return nullptr;
+
+    uintptr_t start = ((uintptr_t)(raw + sizeof(AllocationHeader)) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    unsigned char* memory = (unsigned char*)start;
+    AllocationHeader* header = (AllocationHeader*)memory - 1;
+    header->size = size;
+    header->subsystem = t_subsystem;
+    header->offset = (uint32_t)(memory - raw);
+
+    count(s_subsystems[t_subsystem], (int64_t)size, 1);
+    count(s_total, (int64_t)size, 1);
+    s_frame_allocations.fetch_add(1, std::memory_order_relaxed);
+    return memory;
+}
+
+static void release_tracked(void* memory)
+{
+    if (memory == nullptr) return;
+
+    AllocationHeader* header = (AllocationHeader*)memory - 1;
+    count(s_subsystems[header->subsystem], -(int64_t)header->size, -1);
+    count(s_total, -(int64_t)header->size, -1);
+    free((unsigned char*)memory - header->offset);
+}
+
+static AllocationStats read_counters(const SubsystemCounters& counters)
+{
+    AllocationStats stats;
+    stats.live_bytes = counters.live_bytes.load(std::memory_order_relaxed);
+    stats.live_count = counters.live_count.load(std::memory_order_relaxed);
+    stats.peak_bytes = counters.peak_bytes.load(std::memory_order_relaxed);
+    stats.total_count = counters.total_count.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ————— INTERFACE ————— //
+bool AllocationTracker::is_enabled() { return true; }
+
+void* AllocationTracker::allocate(size_t size) { return allocate_tracked(size, alignof(AllocationHeader)); }
+
+void* AllocationTracker::reallocate(void* memory, size_t size)
+{
+    void* moved = allocate_tracked(size, alignof(AllocationHeader));
+    if (moved == nullptr or memory == nullptr) return moved;
+
+    AllocationHeader* header = (AllocationHeader*)memory - 1;
+    memcpy(moved, memory, std::min((size_t)header->size, size));
+    release_tracked(memory);
+    return moved;
+}
+
+void AllocationTracker::release(void* memory) { release_tracked(memory); }
+
+int64_t AllocationTracker::end_frame()
+{
+    int64_t allocations = s_frame_allocations.exchange(0, std::memory_order_relaxed);
+    s_frames++;
+    s_frame_allocations_total += allocations;
+    s_frame_allocations_max = std::max(s_frame_allocations_max, allocations);
+    return allocations;
+}
+
+AllocationStats AllocationTracker::get_stats(AllocationSubsystem subsystem) { return read_counters(s_subsystems[subsystem]); }
+
+AllocationStats AllocationTracker::get_total() { return read_counters(s_total); }
+
+void AllocationTracker::report()
+{
+    printf("%-12s %12s %10s %12s %12s\n", "subsystem", "live bytes", "live", "peak bytes", "allocations");
+    for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++)
+    {
+        AllocationStats stats = get_stats((AllocationSubsystem)i);
+        if (stats.total_count == 0) continue;
+        printf("%-12s %12lld %10lld %12lld %12lld\n", SUBSYSTEM_NAMES[i], (long long)stats.live_bytes,
+               (long long)stats.live_count, (long long)stats.peak_bytes, (long long)stats.total_count);
+    }
+
+    AllocationStats total = get_total();
+    printf("%-12s %12lld %10lld %12lld %12lld\n", "total", (long long)total.live_bytes,
+           (long long)total.live_count, (long long)total.peak_bytes, (long long)total.total_count);
+    if (s_frames > 0)
+    {
+        printf("allocations per frame: %.1f on average, %lld at most, over %lld frames\n",
+               (double)s_frame_allocations_total / s_frames, (long long)s_frame_allocations_max, (long long)s_frames);
+    }
+    fflush(stdout);
+}
+
+// ————— GLOBAL NEW AND DELETE ————— //
+static void* allocate_or_throw(size_t size, size_t alignment)
+{
+    void* memory = allocate_tracked(size, alignment);
+    if (memory == nullptr) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size) { return allocate_or_throw(size, alignof(AllocationHeader)); }
+void* operator new[](size_t size) { return allocate_or_throw(size, alignof(AllocationHeader)); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocate_or_throw(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocate_or_throw(size, (size_t)alignment); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate_tracked(size, alignof(AllocationHeader)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate_tracked(size, alignof(AllocationHeader)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate_tracked(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate_tracked(size, (size_t)alignment); }
+
+void operator delete(void* memory) noexcept { release_tracked(memory); }
+void operator delete[](void* memory) noexcept { release_tracked(memory); }
+void operator delete(void* memory, size_t) noexcept { release_tracked(memory); }
+void operator delete[](void* memory, size_t) noexcept { release_tracked(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { release_tracked(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { release_tracked(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { release_tracked(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { release_tracked(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { release_tracked(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { release_tracked(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { release_tracked(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { release_tracked(memory); }
+
+#else
+
+bool AllocationTracker::is_enabled() { return false; }
+void* AllocationTracker::allocate(size_t size) { return malloc(size); }
+void* AllocationTracker::reallocate(void* memory, size_t size) { return realloc(memory, size); }
+void AllocationTracker::release(void* memory) { free(memory); }
+int64_t AllocationTracker::end_frame() { return 0; }
+AllocationStats AllocationTracker::get_stats(AllocationSubsystem) { return AllocationStats(); }
+AllocationStats AllocationTracker::get_total() { return AllocationStats(); }
+void AllocationTracker::report() {}
+
+#endif
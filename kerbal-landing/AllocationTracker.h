@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// What an allocation was for; whatever ALLOCATION_SCOPE was innermost on the
+// allocating thread at the time.
+enum AllocationSubsystem
+{
+    ALLOC_OTHER,
+    ALLOC_ENTITIES,     // the run arena: the world's components, animations included
+    ALLOC_SEQUENCES,    // coroutine frames
+    ALLOC_TEXTURES,     // decoded images and their converted texels
+    ALLOC_TERRAIN,
+    ALLOC_PARTICLES,
+    ALLOC_SHADERS,      // source files read in for compiling
+    ALLOC_LEVEL,
+    ALLOC_RENDERING,    // draw lists
+    ALLOC_HOT_RELOAD,
+    ALLOC_RECORDING,    // headless frame capture
+    ALLOC_JOBS,
+    ALLOC_PROFILER,
+    ALLOC_TELEMETRY,
+    ALLOC_SUBSYSTEM_COUNT
+};
+
+struct AllocationStats
+{
+    int64_t live_bytes = 0;
+    int64_t live_count = 0;
+    int64_t peak_bytes = 0;    // most live at once
+    int64_t total_count = 0;   // ever made
+};
+
+/**
+* Heap accounting, for finding where memory goes over a long run. Built with
+* KERBAL_TRACK_ALLOCATIONS defined, it replaces the global operator new and delete
+* and takes over stb_image's allocator, and tags every block with the subsystem it
+* was made for; the tag travels with the block, so it is counted back off the same
+* subsystem whichever thread frees it. Without the define, nothing is hooked and
+* every query comes back empty.
+*
+* While tracking is built in, each block carries a 16-byte header and up to
+* alignment - 1 bytes of slack, to line it up whatever malloc() returns.
+**/
+class AllocationTracker
+{
+public:
+    static bool is_enabled();
+
+    // malloc(), realloc() and free(), counted against the current subsystem; for
+    // memory that doesn't come from new, like stb_image's and the arena's
+    static void* allocate(size_t size);
+    static void* reallocate(void* memory, size_t size);
+    static void  release(void* memory);
+
+    // the calling thread's current subsystem; returns the one it replaces
+    static AllocationSubsystem set_subsystem(AllocationSubsystem subsystem);
+
+    // call once per frame, on one thread; returns the allocations made, on every
+    // thread, since the last call
+    static int64_t end_frame();
+
+    static AllocationStats get_stats(AllocationSubsystem subsystem);
+    static AllocationStats get_total();
+    static const char* get_subsystem_name(AllocationSubsystem subsystem);
+
+    // prints what is still allocated, by subsystem, and the per-frame counts;
+    // anything still live after shutdown has let go of everything is a leak
+    static void report();
+};
+
+// Attributes every allocation on this thread to a subsystem until the end of the scope.
+class AllocationScope
+{
+private:
+    AllocationSubsystem m_previous;
+
+public:
+    explicit AllocationScope(AllocationSubsystem subsystem) : m_previous(AllocationTracker::set_subsystem(subsystem)) {};
+    ~AllocationScope() { AllocationTracker::set_subsystem(m_previous); };
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+#define ALLOCATION_JOIN_NAME(a, b) a##b
+#define ALLOCATION_SCOPE_NAME(line) ALLOCATION_JOIN_NAME(allocation_scope_, line)
+#define ALLOCATION_SCOPE(subsystem) AllocationScope ALLOCATION_SCOPE_NAME(__LINE__)(subsystem)
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <cstdlib>
+#include "Arena.h"
+#include "AllocationTracker.h"
+
+void Arena::load(size_t capacity)
+{
+    ALLOCATION_SCOPE(ALLOC_ENTITIES);
+    m_memory = (unsigned char*)AllocationTracker::allocate(capacity);
+    m_capacity = m_memory != nullptr ? capacity : 0;
+    m_used = 0;
+    m_peak = 0;
+}
+
+void Arena::cleanup()
+{
+    AllocationTracker::release(m_memory);
+    m_memory = nullptr;
+    m_capacity = 0;
+    m_used = 0;
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    // alignment is always a power of two
+    size_t start = (m_used + alignment - 1) & ~(alignment - 1);
+    if (start + size > m_capacity)
+    {
+        std::cout << "Arena out of memory: " << size << " bytes requested, "
+                  << (m_capacity - m_used) << " of " << m_capacity << " free" << std::endl;
+        return nullptr;
+    }
+
+    m_used = start + size;
+    if (m_used > m_peak) m_peak = m_used;
+    return m_memory + start;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+* A linear (bump) allocator over one block of memory reserved up front. allocate()
+* just advances an offset, nothing is ever freed individually, and reset() hands
+* the whole block back at once in O(1), which makes it a good home for anything
+* that lives exactly as long as one run of the game.
+*
+* Memory comes back uninitialised, and nothing is destroyed on reset(), so only
+* trivially destructible types belong in an arena.
+**/
+class Arena
+{
+private:
+    unsigned char* m_memory = nullptr;
+    size_t m_capacity = 0;
+    size_t m_used = 0;
+    size_t m_peak = 0;       // most ever in use at once; shown against the capacity by the F5 overlay
+
+public:
+    void load(size_t capacity);
+    void cleanup();
+
+    // NULL when the arena is full
+    void* allocate(size_t size, size_t alignment);
+    void  reset() { m_used = 0; };
+
+    template <typename T>
+    T* allocate_array(int count) { return (T*)allocate(sizeof(T) * count, alignof(T)); };
+
+    size_t const get_peak()     const { return m_peak;     };
+    size_t const get_capacity() const { return m_capacity; };
+};
@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include "Benchmark.h"
+#include "Systems.h"
+#include "Texture.h"
+
+const uint64_t SAMPLE_TIME_NS = 2000000;         // 2 ms
+const uint64_t BENCHMARK_TIME_NS = 500000000;    // 0.5 s, the usual limit for one benchmark
+const int MIN_SAMPLES = 5;
+const int MAX_SAMPLES = 200;
+
+void BenchmarkSuite::load()
+{
+    m_clock.reset();
+    m_results.clear();
+    m_context.clear();
+}
+
+void BenchmarkSuite::add_context(const char* key, const std::string& value)
+{
+    m_context.push_back({ key, value });
+}
+
+void BenchmarkSuite::run(const std::string& name, int parameter, BenchmarkFunction function, void* data)
+{
+    // ————— CALIBRATION ————— //
+    // the warm-up doubles as the first guess at how many iterations fill a sample
+    uint64_t start = m_clock.get_time_ns();
+    function(data);
+    uint64_t once = m_clock.get_time_ns() - start;
+
+    int64_t iterations = 1;
+    while (once * iterations < SAMPLE_TIME_NS and iterations < (1 << 24)) iterations *= 2;
+
+    // ————— SAMPLES ————— //
+    std::vector<double> times;
+    uint64_t benchmark_start = m_clock.get_time_ns();
+    while ((int)times.size() < MAX_SAMPLES)
+    {
+        uint64_t sample_start = m_clock.get_time_ns();
+        for (int64_t i = 0; i < iterations; i++) function(data);
+        uint64_t sample_end = m_clock.get_time_ns();
+        times.push_back((double)(sample_end - sample_start) / iterations);
+
+        if ((int)times.size() >= MIN_SAMPLES and sample_end - benchmark_start >= BENCHMARK_TIME_NS) break;
+    }
+
+    // ————— STATISTICS ————— //
+    std::sort(times.begin(), times.end());
+    double total = 0.0;
+    for (double time : times) total += time;
+
+    BenchmarkResult result;
+    result.name = name;
+    result.parameter = parameter;
+    result.samples = (int)times.size();
+    result.iterations = iterations;
+    result.min_ns = times.front();
+    result.median_ns = times[times.size() / 2];
+    result.mean_ns = total / times.size();
+    result.p95_ns = times[std::min(times.size() - 1, times.size() * 95 / 100)];
+    m_results.push_back(result);
+}
+
+void BenchmarkSuite::print() const
+{
+    printf("%-40s %8s %12s %12s %12s %12s\n", "benchmark", "param", "min ns", "median ns", "mean ns", "p95 ns");
+    for (const BenchmarkResult& result : m_results)
+    {
+        printf("%-40s %8d %12.0f %12.0f %12.0f %12.0f\n", result.name.c_str(), result.parameter,
+               result.min_ns, result.median_ns, result.mean_ns, result.p95_ns);
+    }
+}
+
+// the names are paths at worst, but Windows ones have backslashes
+void write_json_string(FILE* file, const std::string& text)
+{
+    fputc('"', file);
+    for (char character : text)
+    {
+        if (character == '"' or character == '\\') fputc('\\', file);
+        if ((unsigned char)character < 0x20) fprintf(file, "\\u%04x", character);
+        else fputc(character, file);
+    }
+    fputc('"', file);
+}
+
+bool BenchmarkSuite::write_json(const char* filepath) const
+{
+    FILE* file = fopen(filepath, "w");
+    if (file == NULL)
+    {
+        std::cout << "Unable to write benchmark results: " << filepath << std::endl;
+        return false;
+    }
+
+    fprintf(file, "{\n  \"context\": {");
+    for (size_t i = 0; i < m_context.size(); i++)
+    {
+        fprintf(file, "%s\n    ", i == 0 ? "" : ",");
+        write_json_string(file, m_context[i].first);
+        fprintf(file, ": ");
+        write_json_string(file, m_context[i].second);
+    }
+    fprintf(file, "\n  },\n  \"benchmarks\": [");
+
+    for (size_t i = 0; i < m_results.size(); i++)
+    {
+        const BenchmarkResult& result = m_results[i];
+        fprintf(file, "%s\n    { \"name\": ", i == 0 ? "" : ",");
+        write_json_string(file, result.name);
+        fprintf(file, ", \"parameter\": %d, \"samples\": %d, \"iterations\": %lld, "
+                      "\"min_ns\": %.1f, \"median_ns\": %.1f, \"mean_ns\": %.1f, \"p95_ns\": %.1f }",
+                result.parameter, result.samples, (long long)result.iterations,
+                result.min_ns, result.median_ns, result.mean_ns, result.p95_ns);
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    return fclose(file) == 0;
+}
+
+// ————— ENGINE BENCHMARKS ————— //
+
+// a world of its own, laid out so nothing in it ever touches anything else
+struct SystemsBenchmark
+{
+    Arena      arena;
+    World      world;
+    EntityId   mover;
+    JobSystem* jobs;
+    DrawList   list;
+};
+
+static void build_world(SystemsBenchmark& benchmark, int solid_count, int mover_count)
+{
+    benchmark.arena.reset();
+    benchmark.world.load(benchmark.arena, solid_count + mover_count + 1);
+
+    for (int i = 0; i < solid_count; i++)
+    {
+        EntityId solid = benchmark.world.create();
+        Transform& transform = benchmark.world.transforms.add(solid);
+        transform.position = glm::vec2(i * 2.0f, -10.0f);
+        transform.scale = glm::vec2(0.5f);
+        benchmark.world.solids.add(solid);
+        benchmark.world.sprites.add(solid);
+    }
+
+    for (int i = 0; i < mover_count; i++)
+    {
+        EntityId mover = benchmark.world.create();
+        Transform& transform = benchmark.world.transforms.add(mover);
+        transform.position = glm::vec2(i * 2.0f, 10.0f);
+        transform.scale = glm::vec2(0.5f);
+        benchmark.world.motions.add(mover).rotation = 1.0f;
+        benchmark.world.colliders.add(mover);
+        benchmark.world.sprites.add(mover);
+        benchmark.mover = mover;
+    }
+}
+
+static void dirty_every_transform(World& world)
+{
+    for (int i = 0; i < world.transforms.size(); i++) world.transforms[i].dirty = true;
+}
+
+void run_system_benchmarks(BenchmarkSuite& suite, JobSystem* jobs)
+{
+    SystemsBenchmark benchmark;
+    benchmark.arena.load(4 * 1024 * 1024);
+    benchmark.jobs = jobs;
+
+    // ————— COLLISIONS ————— //
+    // one collider against every solid, once per axis; the cost the player pays each step
+    const int solid_counts[] = { 1, 16, 64, 256, 1024 };
+    for (int solid_count : solid_counts)
+    {
+        build_world(benchmark, solid_count, 1);
+        suite.run("resolve_collisions_x", solid_count, [](void* data) {
+            SystemsBenchmark* benchmark = (SystemsBenchmark*)data;
+            resolve_collisions(benchmark->world, benchmark->mover, AXIS_X);
+        }, &benchmark);
+        suite.run("resolve_collisions_y", solid_count, [](void* data) {
+            SystemsBenchmark* benchmark = (SystemsBenchmark*)data;
+            resolve_collisions(benchmark->world, benchmark->mover, AXIS_Y);
+        }, &benchmark);
+    }
+
+    // ————— MOTION ————— //
+    // every mover also collides against the 16 solids, once per axis
+    const int mover_counts[] = { 1, 16, 256, 1024 };
+    for (int mover_count : mover_counts)
+    {
+        build_world(benchmark, 16, mover_count);
+        suite.run("update_motion", mover_count, [](void* data) {
+            update_motion(((SystemsBenchmark*)data)->world, 1.0f / 60.0f);
+        }, &benchmark);
+    }
+
+    // ————— TRANSFORMS ————— //
+    const int transform_counts[] = { 64, 1024, 8192 };
+    for (int transform_count : transform_counts)
+    {
+        build_world(benchmark, transform_count, 0);
+        suite.run("update_transforms", transform_count, [](void* data) {
+            SystemsBenchmark* benchmark = (SystemsBenchmark*)data;
+            dirty_every_transform(benchmark->world);
+            update_transforms(benchmark->world);
+        }, &benchmark);
+
+        if (jobs == nullptr or jobs->get_thread_count() < 2) continue;
+        suite.run("update_transforms_jobs", transform_count, [](void* data) {
+            SystemsBenchmark* benchmark = (SystemsBenchmark*)data;
+            dirty_every_transform(benchmark->world);
+            update_transforms(benchmark->world, benchmark->jobs);
+        }, &benchmark);
+    }
+
+    // ————— SPRITES ————— //
+    // recording only; drawing them needs the game's GL state
+    for (int transform_count : transform_counts)
+    {
+        build_world(benchmark, transform_count, 0);
+        update_transforms(benchmark.world);
+        suite.run("render_sprites", transform_count, [](void* data) {
+            SystemsBenchmark* benchmark = (SystemsBenchmark*)data;
+            benchmark->list.commands.clear();
+            render_sprites(benchmark->world, &benchmark->list, LAYER_BACKGROUND, 1.0f);
+        }, &benchmark);
+    }
+
+    benchmark.arena.cleanup();
+}
+
+struct TextureBenchmark
+{
+    const char* filepath;
+};
+
+void run_texture_benchmarks(BenchmarkSuite& suite, const char* const* filepaths, int count)
+{
+    // decoding and conversion only; they are what load_texture() spends its time on,
+    // and what the streaming and reloading threads do off the GL thread
+    for (int i = 0; i < count; i++)
+    {
+        TextureBenchmark benchmark = { filepaths[i] };
+        suite.run(std::string("decode_texture ") + filepaths[i], 0, [](void* data) {
+            int width, height;
+            unsigned char* pixels = load_image_pixels(((TextureBenchmark*)data)->filepath, &width, &height);
+            if (pixels == NULL) return;
+
+            TextureData texture;
+            encode_texture(pixels, width, height, TEXTURE_AUTO, texture);
+            free_image_pixels(pixels);
+        }, &benchmark);
+    }
+}
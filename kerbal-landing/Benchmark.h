@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "GameClock.h"
+#include "JobSystem.h"
+
+// One iteration of whatever is being measured.
+typedef void (*BenchmarkFunction)(void* data);
+
+// Times are per iteration, in nanoseconds.
+struct BenchmarkResult
+{
+    std::string name;
+    int         parameter;     // what the benchmark varies: entity count, batch size...; 0 if nothing
+    int         samples;
+    int64_t     iterations;    // per sample
+    double      min_ns,
+                median_ns,
+                mean_ns,
+                p95_ns;
+};
+
+/**
+* Runs benchmarks and collects their results, for printing and for writing out as
+* JSON so that runs can be compared with each other over time.
+*
+* Each benchmark is run once to warm up, then timed in samples: a sample is
+* however many iterations it takes to fill SAMPLE_TIME, so cheap functions aren't
+* lost in the clock's resolution, and there are as many samples as fit in
+* BENCHMARK_TIME, within MIN_SAMPLES and MAX_SAMPLES. Reporting the median and
+* the 95th percentile as well as the mean keeps one descheduled sample from
+* passing for a regression.
+**/
+class BenchmarkSuite
+{
+private:
+    SystemTimeSource                                 m_clock;
+    std::vector<BenchmarkResult>                     m_results;
+    std::vector<std::pair<std::string, std::string>> m_context;   // what the numbers were measured on
+
+public:
+    void load();
+
+    void add_context(const char* key, const std::string& value);
+    void run(const std::string& name, int parameter, BenchmarkFunction function, void* data);
+
+    void print() const;
+    bool write_json(const char* filepath) const;
+
+    const std::vector<BenchmarkResult>& get_results() const { return m_results; };
+};
+
+// Writes text as a quoted, escaped JSON string.
+void write_json_string(FILE* file, const std::string& text);
+
+// Benchmarks of the engine on its own, away from the game: the systems over
+// synthetic worlds of increasing size, and decoding each of the given images.
+void run_system_benchmarks(BenchmarkSuite& suite, JobSystem* jobs);
+void run_texture_benchmarks(BenchmarkSuite& suite, const char* const* filepaths, int count);
@@ -0,0 +1,208 @@
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include "glm/common.hpp"
+#include "Collision.h"
+
+static const float DEGREES_TO_RADIANS = 3.14159265358979f / 180.0f;
+
+static float cross(glm::vec2 o, glm::vec2 a, glm::vec2 b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+static float dot(glm::vec2 a, glm::vec2 b)
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+// ————— HULLS ————— //
+bool build_alpha_hull(const unsigned char* pixels, int width, int height, unsigned char alpha_threshold, ConvexHull& hull)
+{
+    // STEP 1: Only the outermost opaque pixel either side of each row can be on the hull;
+    //         take all four corners of both, so the hull covers them completely
+    std::vector<glm::vec2> corners;
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char* row = pixels + (size_t)y * width * 4;
+        int left = 0, right = width - 1;
+        while (left < width and row[left * 4 + 3] < alpha_threshold) left++;
+        if (left == width) continue;
+        while (row[right * 4 + 3] < alpha_threshold) right--;
+
+        float x0 = (float)left / width - 0.5f, x1 = (float)(right + 1) / width - 0.5f;
+        float y0 = 0.5f - (float)y / height, y1 = 0.5f - (float)(y + 1) / height;
+        corners.insert(corners.end(), { glm::vec2(x0, y0), glm::vec2(x1, y0), glm::vec2(x0, y1), glm::vec2(x1, y1) });
+    }
+    hull.points.clear();
+    if (corners.empty()) return false;
+
+    // STEP 2: Andrew's monotone chain, lower half then upper, dropping points in line
+    //         with their neighbours
+    std::sort(corners.begin(), corners.end(), [](glm::vec2 a, glm::vec2 b) { return a.x < b.x or (a.x == b.x and a.y < b.y); });
+    std::vector<glm::vec2>& points = hull.points;
+    points.resize(2 * corners.size());
+    int count = 0;
+    for (size_t i = 0; i < corners.size(); i++)
+    {
+        while (count >= 2 and cross(points[count - 2], points[count - 1], corners[i]) <= 0.0f) count--;
+        points[count++] = corners[i];
+    }
+    for (int i = (int)corners.size() - 2, lower = count + 1; i >= 0; i--)
+    {
+        while (count >= lower and cross(points[count - 2], points[count - 1], corners[i]) <= 0.0f) count--;
+        points[count++] = corners[i];
+    }
+    points.resize(count - 1);   // the last point is the first again
+
+    // STEP 3: Pixel staircases leave far more points than the shape needs; drop edges
+    //         by extending the edges either side until they meet, which only ever
+    //         grows the hull, each time taking whichever edge grows it least
+    while ((int)points.size() > PlacedHull::MAX_POINTS / 2)
+    {
+        int n = (int)points.size();
+        int best = -1;
+        float bestArea = FLT_MAX;
+        glm::vec2 bestPoint;
+        for (int i = 0; i < n; i++)
+        {
+            // edge i runs from points[i] to points[i + 1]; its neighbours meet at apex
+            glm::vec2 p0 = points[(i + n - 1) % n], p1 = points[i], p2 = points[(i + 1) % n], p3 = points[(i + 2) % n];
+            glm::vec2 d0 = p1 - p0, d1 = p2 - p3;
+            float denominator = d0.x * d1.y - d0.y * d1.x;
+            if (denominator >= 0.0f) continue;   // the neighbours don't meet beyond this edge
+
+            float t = ((p3.x - p0.x) * d1.y - (p3.y - p0.y) * d1.x) / denominator;
+            glm::vec2 apex = p0 + d0 * t;
+            float area = cross(p1, apex, p2);
+            if (area < 0.0f) area = -area;
+            if (area < bestArea)
+            {
+                best = i;
+                bestArea = area;
+                bestPoint = apex;
+            }
+        }
+        if (best < 0) break;
+
+        points[best] = bestPoint;
+        points.erase(points.begin() + (best + 1) % n);
+    }
+
+    return true;
+}
+
+void place_hull(const ConvexHull& hull, glm::vec2 position, float angle_degrees, glm::vec2 scale, PlacedHull& placed)
+{
+    float sine = sinf(angle_degrees * DEGREES_TO_RADIANS);
+    float cosine = cosf(angle_degrees * DEGREES_TO_RADIANS);
+
+    placed.count = std::min((int)hull.points.size(), PlacedHull::MAX_POINTS);
+    placed.min = glm::vec2(FLT_MAX);
+    placed.max = glm::vec2(-FLT_MAX);
+    for (int i = 0; i < placed.count; i++)
+    {
+        glm::vec2 local = hull.points[i] * scale;
+        glm::vec2 point = position + glm::vec2(cosine * local.x - sine * local.y, sine * local.x + cosine * local.y);
+        placed.points[i] = point;
+        placed.min = glm::min(placed.min, point);
+        placed.max = glm::max(placed.max, point);
+    }
+
+    // turning and uneven scaling both keep it convex and anticlockwise (for positive scales)
+    for (int i = 0; i < placed.count; i++)
+    {
+        glm::vec2 edge = placed.points[(i + 1) % placed.count] - placed.points[i];
+        placed.normals[i] = glm::vec2(edge.y, -edge.x);
+        placed.offsets[i] = dot(placed.normals[i], placed.points[i]);
+    }
+}
+
+bool hull_touches_segment(const PlacedHull& hull, glm::vec2 a, glm::vec2 b)
+{
+    // STEP 1: The hull's own edges: the segment wholly outside any one of them misses
+    for (int i = 0; i < hull.count; i++)
+    {
+        if (dot(hull.normals[i], a) > hull.offsets[i] and dot(hull.normals[i], b) > hull.offsets[i]) return false;
+    }
+
+    // STEP 2: The segment's line: the hull wholly to one side of it misses
+    bool left = false, right = false;
+    for (int i = 0; i < hull.count; i++)
+    {
+        float side = cross(a, b, hull.points[i]);
+        left = left or side >= 0.0f;
+        right = right or side <= 0.0f;
+        if (left and right) return true;
+    }
+    return false;
+}
+
+// ————— SEGMENT BVH ————— //
+void SegmentBVH::build(const std::vector<glm::vec2>& ends)
+{
+    m_ends = ends;
+    int segment_count = (int)m_ends.size() / 2;
+    int leaf_count = (segment_count + SEGMENTS_PER_LEAF - 1) / SEGMENTS_PER_LEAF;
+
+    // round up to a power of two so the tree is complete; spare leaves get empty boxes
+    int leaf_capacity = 1;
+    while (leaf_capacity < leaf_count) leaf_capacity *= 2;
+    m_leaf_base = leaf_capacity - 1;
+    m_boxes.assign(2 * leaf_capacity - 1, { glm::vec2(FLT_MAX), glm::vec2(-FLT_MAX) });
+
+    for (int segment = 0; segment < segment_count; segment++)
+    {
+        Box& leaf = m_boxes[m_leaf_base + segment / SEGMENTS_PER_LEAF];
+        leaf.min = glm::min(leaf.min, glm::min(m_ends[2 * segment], m_ends[2 * segment + 1]));
+        leaf.max = glm::max(leaf.max, glm::max(m_ends[2 * segment], m_ends[2 * segment + 1]));
+    }
+    for (int node = m_leaf_base - 1; node >= 0; node--)
+    {
+        m_boxes[node].min = glm::min(m_boxes[2 * node + 1].min, m_boxes[2 * node + 2].min);
+        m_boxes[node].max = glm::max(m_boxes[2 * node + 1].max, m_boxes[2 * node + 2].max);
+    }
+}
+
+void SegmentBVH::clear()
+{
+    m_ends.clear();
+    m_boxes.clear();
+    m_leaf_base = 0;
+}
+
+bool SegmentBVH::touches(const PlacedHull& hull) const
+{
+    if (m_boxes.empty()) return false;
+
+    // the tree is at most 32 deep, and a node's children are pushed only after it is popped
+    int stack[64];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        int node = stack[--depth];
+        const Box& box = m_boxes[node];
+        if (box.min.x > hull.max.x or box.max.x < hull.min.x or box.min.y > hull.max.y or box.max.y < hull.min.y) continue;
+
+        if (node < m_leaf_base)
+        {
+            stack[depth++] = 2 * node + 2;
+            stack[depth++] = 2 * node + 1;
+            continue;
+        }
+
+        int first = (node - m_leaf_base) * SEGMENTS_PER_LEAF;
+        int last = std::min(first + SEGMENTS_PER_LEAF, (int)m_ends.size() / 2);
+        for (int segment = first; segment < last; segment++)
+        {
+            // a leaf's box is loose around most of its segments, and this is far cheaper than the test
+            glm::vec2 a = m_ends[2 * segment], b = m_ends[2 * segment + 1];
+            if (std::max(a.x, b.x) < hull.min.x or std::min(a.x, b.x) > hull.max.x or
+                std::max(a.y, b.y) < hull.min.y or std::min(a.y, b.y) > hull.max.y) continue;
+
+            if (hull_touches_segment(hull, a, b)) return true;
+        }
+    }
+    return false;
+}
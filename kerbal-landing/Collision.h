@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include "glm/vec2.hpp"
+
+/**
+* Convex outlines and the line segments they are tested against, for collisions
+* that have to follow a sprite's shape and turn with it.
+*
+* Hulls are tested against segments with the separating axis theorem: they miss
+* if some hull edge has the whole segment outside it, or the segment's line has
+* the whole hull to one side, and touch otherwise. That is exact for any convex
+* hull and costs two passes over its points per segment, so segments are kept
+* in a SegmentBVH and only those near the hull are tested at all.
+**/
+
+// A sprite's outline: convex, counter-clockwise, in the shared quad's space
+// (-0.5..0.5 each way, the top of the image at +0.5).
+struct ConvexHull
+{
+    std::vector<glm::vec2> points;
+};
+
+// The convex hull of every pixel at least alpha_threshold opaque, corners and all;
+// pixels are top-row-first RGBA8. False if no pixel is opaque enough.
+bool build_alpha_hull(const unsigned char* pixels, int width, int height, unsigned char alpha_threshold, ConvexHull& hull);
+
+// A hull as it stands in the world, with what the tests need worked out once.
+struct PlacedHull
+{
+    static const int MAX_POINTS = 64;
+
+    glm::vec2 points[MAX_POINTS];
+    glm::vec2 normals[MAX_POINTS];   // outward, of the edge from points[i] to points[i + 1]
+    float     offsets[MAX_POINTS];   // of that edge along its normal; the hull is all at or below it
+    int       count = 0;
+    glm::vec2 min, max;              // bounding box
+};
+
+// Scales the hull, turns it angle_degrees anticlockwise about its centre and moves
+// it to position, the way Transform2D places a sprite. Points past MAX_POINTS are
+// dropped, so build hulls with fewer.
+void place_hull(const ConvexHull& hull, glm::vec2 position, float angle_degrees, glm::vec2 scale, PlacedHull& placed);
+
+bool hull_touches_segment(const PlacedHull& hull, glm::vec2 a, glm::vec2 b);
+
+/**
+* A fixed set of segments under a tree of bounding boxes. Segments are grouped
+* into leaves in the order they are given, so runs that are close together in
+* space (like a terrain profile, left to right) give tight boxes.
+*
+* Built once; read-only after that, so any number of threads may query it at once.
+**/
+class SegmentBVH
+{
+private:
+    static const int SEGMENTS_PER_LEAF = 8;
+
+    struct Box
+    {
+        glm::vec2 min, max;
+    };
+
+    std::vector<glm::vec2> m_ends;         // segment i runs from m_ends[2i] to m_ends[2i + 1]
+    std::vector<Box>       m_boxes;        // a complete binary tree: the root first, the children of i at 2i + 1 and 2i + 2
+    int                    m_leaf_base = 0;   // the index of the first leaf
+
+public:
+    // ends holds two points per segment
+    void build(const std::vector<glm::vec2>& ends);
+    void clear();
+
+    bool touches(const PlacedHull& hull) const;
+
+    int const get_segment_count() const { return (int)m_ends.size() / 2; };
+};
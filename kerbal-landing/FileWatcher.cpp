@@ -0,0 +1,193 @@
+#include <chrono>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "FileWatcher.h"
+#include "Profiler.h"
+
+#ifdef __linux__
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/inotify.h>
+#endif
+
+const int WAKE_INTERVAL_MS = 100;   // how often the thread looks up to see if it should stop
+const int SETTLE_MS = 50;           // quiet time after the last event before a change is reported
+const int POLL_INTERVAL_MS = 250;   // between checks, when there's no inotify
+
+int FileWatcher::add(const char* path)
+{
+    WatchedFile file;
+    file.path = path;
+
+    size_t slash = file.path.find_last_of("/\\");
+    if (slash == std::string::npos)
+    {
+        file.directory = ".";
+        file.name = file.path;
+    }
+    else
+    {
+        file.directory = slash == 0 ? "/" : file.path.substr(0, slash);
+        file.name = file.path.substr(slash + 1);
+    }
+
+    read_file_stamp(file.path, &file.modified, &file.size);
+    m_files.push_back(file);
+    return (int)m_files.size() - 1;
+}
+
+void FileWatcher::start(FileChangedFunction on_changed, void* data)
+{
+    m_on_changed = on_changed;
+    m_data = data;
+
+    if (!start_inotify()) m_inotify = -1;
+
+    m_running = true;
+    m_thread = std::thread(&FileWatcher::thread_loop, this);
+}
+
+void FileWatcher::cleanup()
+{
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+
+#ifdef __linux__
+    if (m_inotify >= 0) close(m_inotify);
+#endif
+    m_inotify = -1;
+    m_files.clear();
+}
+
+bool FileWatcher::start_inotify()
+{
+#ifdef __linux__
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify < 0) return false;
+
+    for (WatchedFile& file : m_files)
+    {
+        // a directory that is already watched gives back the same descriptor
+        file.directory_watch = inotify_add_watch(m_inotify, file.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (file.directory_watch < 0)
+        {
+            close(m_inotify);
+            m_inotify = -1;
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileWatcher::thread_loop()
+{
+    Profiler::set_thread_name("file watcher");
+    std::vector<bool> changed(m_files.size(), false);
+
+    while (m_running)
+    {
+        bool any = m_inotify >= 0 ? wait_inotify(changed) : wait_polling(changed);
+        if (!any) continue;
+
+        for (int i = 0; i < (int)m_files.size(); i++)
+        {
+            if (!changed[i]) continue;
+            changed[i] = false;
+            m_on_changed(m_data, i);
+        }
+    }
+}
+
+bool FileWatcher::wait_inotify(std::vector<bool>& changed)
+{
+#ifdef __linux__
+    bool any = false;
+    int timeout = WAKE_INTERVAL_MS;
+
+    // the first event starts the clock; every one after restarts it, until it runs out
+    while (m_running)
+    {
+        pollfd descriptor = { m_inotify, POLLIN, 0 };
+        if (poll(&descriptor, 1, timeout) <= 0) return any;
+
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* next = buffer; next < buffer + length; )
+            {
+                const inotify_event* event = (const inotify_event*)next;
+                next += sizeof(inotify_event) + event->len;
+                if (event->len == 0) continue;
+
+                for (int i = 0; i < (int)m_files.size(); i++)
+                {
+                    if (m_files[i].directory_watch != event->wd or m_files[i].name != event->name) continue;
+                    changed[i] = true;
+                    any = true;
+                }
+            }
+        }
+
+        // other files in the same directories don't count
+        if (any) timeout = SETTLE_MS;
+    }
+    return false;
+#else
+    return false;
+#endif
+}
+
+bool FileWatcher::wait_polling(std::vector<bool>& changed)
+{
+    for (int waited = 0; waited < POLL_INTERVAL_MS and m_running; waited += WAKE_INTERVAL_MS)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(WAKE_INTERVAL_MS));
+    }
+
+    // a file counts as changed once its stamp has moved and then stayed put for a
+    // whole interval, which is as close as polling gets to waiting for it to settle
+    bool any = false;
+    for (int i = 0; i < (int)m_files.size(); i++)
+    {
+        WatchedFile& file = m_files[i];
+        int64_t modified, size;
+        bool exists = read_file_stamp(file.path, &modified, &size);
+
+        if (modified != file.modified or size != file.size)
+        {
+            file.modified = modified;
+            file.size = size;
+            file.pending = true;
+        }
+        else if (file.pending and exists)
+        {
+            file.pending = false;
+            changed[i] = true;
+            any = true;
+        }
+    }
+    return any;
+}
+
+bool FileWatcher::read_file_stamp(const std::string& path, int64_t* modified, int64_t* size)
+{
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0)
+    {
+        *modified = 0;
+        *size = -1;
+        return false;
+    }
+
+#ifdef __linux__
+    *modified = (int64_t)status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+#else
+    *modified = (int64_t)status.st_mtime;
+#endif
+    *size = (int64_t)status.st_size;
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Called on the watcher's thread with the id add() gave the file that changed.
+typedef void (*FileChangedFunction)(void* data, int id);
+
+/**
+* Watches a fixed set of files from a thread of its own and reports each one that
+* changes, once it has settled.
+*
+* On Linux this is inotify on the files' directories, so the thread sleeps until
+* something is written; watching directories rather than the files themselves
+* also catches editors that save by writing a new file and renaming it over the
+* old one. Elsewhere, or if inotify can't be had, it falls back to comparing every
+* file's modification time and size a few times a second.
+*
+* Editors rarely save in one write, so changes are only reported once a file has
+* gone quiet for a moment, and then only once however many events there were.
+**/
+class FileWatcher
+{
+private:
+    struct WatchedFile
+    {
+        std::string path;
+        std::string directory;
+        std::string name;           // within directory
+        int         directory_watch = -1;
+        int64_t     modified = 0;   // polling only, like size
+        int64_t     size = -1;
+        bool        pending = false;   // changed, but not yet settled
+    };
+
+    std::vector<WatchedFile> m_files;   // indexed by id
+    std::thread              m_thread;
+    std::atomic<bool>        m_running{ false };
+    int                      m_inotify = -1;
+
+    FileChangedFunction m_on_changed = nullptr;
+    void*               m_data = nullptr;
+
+    void thread_loop();
+    bool start_inotify();
+    bool wait_inotify(std::vector<bool>& changed);
+    bool wait_polling(std::vector<bool>& changed);
+    static bool read_file_stamp(const std::string& path, int64_t* modified, int64_t* size);
+
+public:
+    // before start() only; the same file may be added more than once
+    int  add(const char* path);
+
+    void start(FileChangedFunction on_changed, void* data);
+    void cleanup();
+
+    bool const is_polling() const { return m_inotify < 0; };
+};
@@ -0,0 +1,353 @@
+#define GL_SILENCE_DEPRECATION
+
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include "FrameRecorder.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
+
+bool parse_frame_sink_format(const char* name, FrameSinkFormat* format)
+{
+    if (strcmp(name, "raw") == 0) *format = SINK_RAW;
+    else if (strcmp(name, "y4m") == 0) *format = SINK_Y4M;
+    else if (strcmp(name, "png") == 0) *format = SINK_PNG;
+    else return false;
+    return true;
+}
+
+static bool is_frame_pattern(const char* pattern)
+{
+    // exactly one %d, optionally zero-padded (%05d), and no other % at all, since
+    // the pattern is the user's and goes to snprintf() as the format
+    int conversions = 0;
+    for (const char* c = pattern; *c != '\0'; c++)
+    {
+        if (*c != '%') continue;
+        c++;
+        while (*c >= '0' and *c <= '9') c++;
+        if (*c != 'd') return false;
+        conversions++;
+    }
+    return conversions == 1;
+}
+
+bool FrameRecorder::load(int width, int height, int frames_per_second, FrameSinkFormat format, const char* output_path)
+{
+    ALLOCATION_SCOPE(ALLOC_RECORDING);
+    m_width = width;
+    m_height = height;
+    m_format = format;
+    m_output_path = output_path != NULL ? output_path : "";
+
+    // ————— RENDER TARGET ————— //
+    glGenRenderbuffers(1, &m_colour_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colour_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_width, m_height);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colour_buffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Offscreen framebuffer is incomplete" << std::endl;
+        return false;
+    }
+
+    // no output at all: just somewhere to draw, for drawing that is only being timed
+    if (output_path == NULL) return true;
+
+    // ————— READBACK BUFFERS ————— //
+    glGenBuffers(PBO_COUNT, m_pbos);
+    for (int i = 0; i < PBO_COUNT; i++)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbos[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, m_width * m_height * 4, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // ————— SINK ————— //
+    if (m_format != SINK_PNG)
+    {
+        m_stream.open(m_output_path, std::ios::binary);
+        if (m_stream.fail())
+        {
+            std::cout << "Unable to open video output: " << m_output_path << std::endl;
+            return false;
+        }
+
+        if (m_format == SINK_Y4M)
+        {
+            m_stream << "YUV4MPEG2 W" << m_width << " H" << m_height << " F" << frames_per_second << ":1 Ip A1:1 C444\n";
+        }
+    }
+    else if (!is_frame_pattern(output_path))
+    {
+        std::cout << "PNG output needs one %d in the path for the frame number: " << m_output_path << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < MAX_QUEUED_FRAMES; i++)
+    {
+        m_free_buffers.emplace_back(m_width * m_height * 4);
+    }
+
+    m_stopping = false;
+    m_writer = std::thread(&FrameRecorder::writer_loop, this);
+
+    return true;
+}
+
+void FrameRecorder::bind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void FrameRecorder::capture()
+{
+    if (!m_writer.joinable()) return;
+
+    // STEP 1: Queue this frame's readback; with a PBO bound, glReadPixels returns immediately
+    int current = m_frames_captured % PBO_COUNT;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbos[current]);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+
+    // STEP 2: Collect the previous frame, whose transfer has had a whole frame to finish
+    if (m_frames_captured > 0) read_back((m_frames_captured - 1) % PBO_COUNT);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_frames_captured++;
+}
+
+void FrameRecorder::read_back(int pbo_index)
+{
+    // grab a recycled buffer, waiting for the writer if every buffer is still queued
+    std::vector<unsigned char> frame;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_buffer_free.wait(lock, [this] { return !m_free_buffers.empty(); });
+        frame = std::move(m_free_buffers.back());
+        m_free_buffers.pop_back();
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbos[pbo_index]);
+    const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_width * m_height * 4, GL_MAP_READ_BIT);
+    if (pixels != NULL)
+    {
+        memcpy(frame.data(), pixels, frame.size());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queued_frames.push_back(std::move(frame));
+    }
+    m_frame_ready.notify_one();
+}
+
+void FrameRecorder::writer_loop()
+{
+    ALLOCATION_SCOPE(ALLOC_RECORDING);
+    Profiler::set_thread_name("frame writer");
+    while (true)
+    {
+        std::vector<unsigned char> frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_frame_ready.wait(lock, [this] { return m_stopping || !m_queued_frames.empty(); });
+            if (m_queued_frames.empty()) return;  // only reached once stopping
+
+            frame = std::move(m_queued_frames.front());
+            m_queued_frames.pop_front();
+        }
+
+        write_frame(frame);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free_buffers.push_back(std::move(frame));
+        }
+        m_buffer_free.notify_one();
+    }
+}
+
+void FrameRecorder::write_frame(const std::vector<unsigned char>& pixels)
+{
+    PROFILE_ZONE("write frame");
+    // GL hands rows back bottom-up; every sink wants them top-down
+    int stride = m_width * 4;
+
+    switch (m_format) {
+    case SINK_RAW:
+        for (int y = m_height - 1; y >= 0; y--)
+        {
+            m_stream.write((const char*)&pixels[y * stride], stride);
+        }
+        break;
+
+    case SINK_Y4M:
+    {
+        // full-range BT.601, one plane at a time
+        std::vector<unsigned char> plane(m_width * m_height);
+        m_stream << "FRAME\n";
+
+        for (int channel = 0; channel < 3; channel++)
+        {
+            for (int y = 0; y < m_height; y++)
+            {
+                const unsigned char* row = &pixels[(m_height - 1 - y) * stride];
+                for (int x = 0; x < m_width; x++)
+                {
+                    float r = row[x * 4], g = row[x * 4 + 1], b = row[x * 4 + 2];
+                    float value;
+                    if (channel == 0)      value =  0.299f * r + 0.587f * g + 0.114f * b;
+                    else if (channel == 1) value = -0.169f * r - 0.331f * g + 0.500f * b + 128.0f;
+                    else                   value =  0.500f * r - 0.419f * g - 0.081f * b + 128.0f;
+                    plane[y * m_width + x] = (unsigned char)(value < 0.0f ? 0.0f : value > 255.0f ? 255.0f : value + 0.5f);
+                }
+            }
+            m_stream.write((const char*)plane.data(), plane.size());
+        }
+        break;
+    }
+
+    case SINK_PNG:
+        write_png(pixels);
+        break;
+    }
+
+    m_frames_written++;
+}
+
+// ————— PNG ————— //
+// Uncompressed (stored-deflate) PNG: larger files, but no zlib dependency and the
+// writer thread never becomes the bottleneck. Re-encode offline if size matters.
+
+static unsigned int crc32_update(unsigned int crc, const unsigned char* data, size_t length)
+{
+    static unsigned int table[256];
+    static bool table_ready = false;
+    if (!table_ready)
+    {
+        for (unsigned int n = 0; n < 256; n++)
+        {
+            unsigned int c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        table_ready = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void put_u32(std::vector<unsigned char>& out, unsigned int value)
+{
+    out.push_back((value >> 24) & 0xFF);
+    out.push_back((value >> 16) & 0xFF);
+    out.push_back((value >> 8) & 0xFF);
+    out.push_back(value & 0xFF);
+}
+
+static void write_png_chunk(std::ofstream& stream, const char* type, const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> chunk;
+    put_u32(chunk, (unsigned int)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    put_u32(chunk, crc32_update(0, &chunk[4], chunk.size() - 4));
+    stream.write((const char*)chunk.data(), chunk.size());
+}
+
+void FrameRecorder::write_png(const std::vector<unsigned char>& pixels)
+{
+    char filename[512];
+    snprintf(filename, sizeof(filename), m_output_path.c_str(), m_frames_written);
+
+    std::ofstream file(filename, std::ios::binary);
+    if (file.fail())
+    {
+        std::cout << "Unable to write frame: " << filename << std::endl;
+        return;
+    }
+
+    static const unsigned char SIGNATURE[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write((const char*)SIGNATURE, sizeof(SIGNATURE));
+
+    std::vector<unsigned char> header;
+    put_u32(header, m_width);
+    put_u32(header, m_height);
+    header.insert(header.end(), { 8, 6, 0, 0, 0 });  // 8-bit RGBA, no interlace
+    write_png_chunk(file, "IHDR", header);
+
+    // filter byte 0 ("none") before every row, rows flipped to top-down
+    int stride = m_width * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((stride + 1) * m_height);
+    for (int y = m_height - 1; y >= 0; y--)
+    {
+        raw.push_back(0);
+        raw.insert(raw.end(), &pixels[y * stride], &pixels[y * stride] + stride);
+    }
+
+    // zlib stream made of stored blocks of at most 65535 bytes
+    std::vector<unsigned char> zlib = { 0x78, 0x01 };
+    unsigned int adler_a = 1, adler_b = 0;
+    for (size_t offset = 0; offset < raw.size(); offset += 65535)
+    {
+        size_t length = raw.size() - offset < 65535 ? raw.size() - offset : 65535;
+        bool last = offset + length == raw.size();
+
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(length & 0xFF);
+        zlib.push_back((length >> 8) & 0xFF);
+        zlib.push_back(~length & 0xFF);
+        zlib.push_back((~length >> 8) & 0xFF);
+        zlib.insert(zlib.end(), &raw[offset], &raw[offset] + length);
+
+        for (size_t i = offset; i < offset + length; i++)
+        {
+            adler_a = (adler_a + raw[i]) % 65521;
+            adler_b = (adler_b + adler_a) % 65521;
+        }
+    }
+    put_u32(zlib, (adler_b << 16) | adler_a);
+
+    write_png_chunk(file, "IDAT", zlib);
+    write_png_chunk(file, "IEND", {});
+}
+
+void FrameRecorder::cleanup()
+{
+    // the most recent frame is still sitting in a PBO
+    if (m_frames_captured > 0)
+    {
+        read_back((m_frames_captured - 1) % PBO_COUNT);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    if (m_writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_frame_ready.notify_one();
+        m_writer.join();
+    }
+
+    if (m_stream.is_open()) m_stream.close();
+    std::vector<std::vector<unsigned char>>().swap(m_free_buffers);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteBuffers(PBO_COUNT, m_pbos);
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteRenderbuffers(1, &m_colour_buffer);
+}
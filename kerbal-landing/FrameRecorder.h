@@ -0,0 +1,75 @@
+#pragma once
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+enum FrameSinkFormat { SINK_RAW, SINK_Y4M, SINK_PNG };
+
+/**
+* Renders into an offscreen framebuffer and streams every finished frame to disk.
+*
+* Readback goes through two pixel buffer objects used round-robin: capture() queues
+* a glReadPixels into one PBO and maps the *other* one, which was filled a frame
+* earlier and is long done by now, so the CPU never waits on the GPU. Mapped pixels
+* are copied into a recycled buffer and handed to a writer thread that does the
+* format conversion and file I/O.
+*
+* Sinks:
+*   SINK_RAW  one file of back-to-back RGBA8 frames, top row first
+*   SINK_Y4M  a 4:4:4 YUV4MPEG2 stream that ffmpeg and most players read directly
+*   SINK_PNG  one PNG per frame; the output path holds one %d for the frame number ("out/%05d.png")
+**/
+class FrameRecorder
+{
+private:
+    static const int PBO_COUNT = 2;
+    static const int MAX_QUEUED_FRAMES = 8;  // writer falls behind → capture() blocks
+
+    // ————— GL SIDE ————— //
+    int    m_width = 0,
+           m_height = 0;
+    GLuint m_framebuffer = 0;
+    GLuint m_colour_buffer = 0;
+    GLuint m_pbos[PBO_COUNT] = { 0 };
+    int    m_frames_captured = 0;
+
+    // ————— WRITER SIDE ————— //
+    FrameSinkFormat m_format = SINK_RAW;
+    std::string     m_output_path;
+    std::ofstream   m_stream;
+    int             m_frames_written = 0;
+
+    std::thread                             m_writer;
+    std::mutex                              m_mutex;
+    std::condition_variable                 m_frame_ready;
+    std::condition_variable                 m_buffer_free;
+    std::deque<std::vector<unsigned char>>  m_queued_frames;
+    std::vector<std::vector<unsigned char>> m_free_buffers;
+    bool                                    m_stopping = false;
+
+    void read_back(int pbo_index);
+    void writer_loop();
+    void write_frame(const std::vector<unsigned char>& pixels);
+    void write_png(const std::vector<unsigned char>& pixels);
+
+public:
+    // a NULL output_path gives the render target alone, and capture() does nothing
+    bool load(int width, int height, int frames_per_second, FrameSinkFormat format, const char* output_path);
+    void bind();
+    void capture();
+    void cleanup();
+
+    int const get_frames_captured() const { return m_frames_captured; };
+};
+
+bool parse_frame_sink_format(const char* name, FrameSinkFormat* format);
@@ -0,0 +1,60 @@
+#include <mutex>
+#include <unordered_map>
+#include "GLStats.h"
+
+GLFrameStats GLStats::s_current;
+
+static std::mutex                          s_last_mutex;
+static GLFrameStats                        s_last;            // under s_last_mutex
+static GLFrameStats                        s_totals;          // under s_last_mutex
+static std::unordered_map<GLuint, int64_t> s_texture_sizes;   // GL thread only
+static int64_t                             s_texture_bytes = 0;
+
+void GLStats::end_frame()
+{
+    s_current.texture_bytes = s_texture_bytes;
+    {
+        std::lock_guard<std::mutex> lock(s_last_mutex);
+        s_last = s_current;
+        s_totals.draw_calls += s_current.draw_calls;
+        s_totals.vertices += s_current.vertices;
+        s_totals.program_binds += s_current.program_binds;
+        s_totals.texture_binds += s_current.texture_binds;
+        s_totals.vertex_array_binds += s_current.vertex_array_binds;
+        s_totals.uniform_uploads += s_current.uniform_uploads;
+        s_totals.attribute_toggles += s_current.attribute_toggles;
+        s_totals.texture_bytes = s_current.texture_bytes;
+    }
+    s_current = GLFrameStats();
+}
+
+GLFrameStats GLStats::get_last_frame()
+{
+    std::lock_guard<std::mutex> lock(s_last_mutex);
+    return s_last;
+}
+
+GLFrameStats GLStats::get_totals()
+{
+    std::lock_guard<std::mutex> lock(s_last_mutex);
+    return s_totals;
+}
+
+void GLStats::set_texture_size(GLuint texture_id, int64_t bytes)
+{
+    int64_t& size = s_texture_sizes[texture_id];
+    s_texture_bytes += bytes - size;
+    size = bytes;
+}
+
+void GLStats::forget_textures(const GLuint* texture_ids, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        auto texture = s_texture_sizes.find(texture_ids[i]);
+        if (texture == s_texture_sizes.end()) continue;
+
+        s_texture_bytes -= texture->second;
+        s_texture_sizes.erase(texture);
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+
+// What was asked of the driver over one frame.
+struct GLFrameStats
+{
+    int     draw_calls = 0;
+    int64_t vertices = 0;
+    int     program_binds = 0;        // glUseProgram
+    int     texture_binds = 0;        // glBindTexture
+    int     vertex_array_binds = 0;   // glBindVertexArray; what attribute state costs per frame, with VAOs
+    int     uniform_uploads = 0;      // glUniform*
+    int     attribute_toggles = 0;    // glEnable/DisableVertexAttribArray
+    int64_t texture_bytes = 0;        // every texture resident at the end of the frame, mip chains included
+};
+
+/**
+* Counts GL traffic, so that batching and state caching can be shown to cut it, and
+* a change that adds to it shows up in review. The gl_* functions below stand in for
+* the GL calls they are named after, counting each one as they make it; everything
+* that draws or sets state goes through them.
+*
+* Only the thread holding the GL context counts, so the counts are plain integers;
+* end_frame() copies them out for other threads to read with get_last_frame().
+**/
+class GLStats
+{
+public:
+    // the frame in progress; for the gl_* functions
+    static GLFrameStats& current() { return s_current; };
+
+    // call on the GL thread once a frame is drawn; starts counting the next
+    static void end_frame();
+    static GLFrameStats get_last_frame();
+
+    // every frame ended so far, added up; texture_bytes is the last frame's
+    static GLFrameStats get_totals();
+
+    // texture memory, by name; setting a size again replaces the old one
+    static void set_texture_size(GLuint texture_id, int64_t bytes);
+    static void forget_textures(const GLuint* texture_ids, int count);
+
+private:
+    static GLFrameStats s_current;
+};
+
+// ————— COUNTED CALLS ————— //
+inline void gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
+{
+    GLStats::current().draw_calls++;
+    GLStats::current().vertices += count;
+    glDrawArrays(mode, first, count);
+}
+
+inline void gl_use_program(GLuint program)
+{
+    GLStats::current().program_binds++;
+    glUseProgram(program);
+}
+
+inline void gl_bind_texture(GLenum target, GLuint texture)
+{
+    GLStats::current().texture_binds++;
+    glBindTexture(target, texture);
+}
+
+inline void gl_bind_vertex_array(GLuint vertex_array)
+{
+    GLStats::current().vertex_array_binds++;
+    glBindVertexArray(vertex_array);
+}
+
+inline void gl_enable_vertex_attrib_array(GLuint index)
+{
+    GLStats::current().attribute_toggles++;
+    glEnableVertexAttribArray(index);
+}
+
+inline void gl_disable_vertex_attrib_array(GLuint index)
+{
+    GLStats::current().attribute_toggles++;
+    glDisableVertexAttribArray(index);
+}
+
+inline void gl_uniform_1f(GLint location, GLfloat x)
+{
+    GLStats::current().uniform_uploads++;
+    glUniform1f(location, x);
+}
+
+inline void gl_uniform_4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
+{
+    GLStats::current().uniform_uploads++;
+    glUniform4f(location, x, y, z, w);
+}
+
+inline void gl_uniform_3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    GLStats::current().uniform_uploads++;
+    glUniform3fv(location, count, value);
+}
+
+inline void gl_uniform_4fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    GLStats::current().uniform_uploads++;
+    glUniform4fv(location, count, value);
+}
+
+inline void gl_uniform_matrix_4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    GLStats::current().uniform_uploads++;
+    glUniformMatrix4fv(location, count, transpose, value);
+}
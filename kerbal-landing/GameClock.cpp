@@ -0,0 +1,64 @@
+#include <SDL.h>
+#include "GameClock.h"
+
+// ————— SYSTEM TIME ————— //
+
+void SystemTimeSource::reset()
+{
+    m_frequency = SDL_GetPerformanceFrequency();
+    m_origin = SDL_GetPerformanceCounter();
+}
+
+uint64_t SystemTimeSource::get_time_ns()
+{
+    // whole seconds and the remainder separately, so ticks * 1e9 can't overflow
+    uint64_t ticks = SDL_GetPerformanceCounter() - m_origin;
+    uint64_t seconds = ticks / m_frequency;
+    uint64_t remainder = ticks % m_frequency;
+    return seconds * NANOSECONDS_IN_SECOND + remainder * NANOSECONDS_IN_SECOND / m_frequency;
+}
+
+// ————— GAME CLOCK ————— //
+
+void GameClock::load(TimeSource* source, uint64_t step_ns, int max_steps)
+{
+    m_source = source;
+    m_step_ns = step_ns;
+    m_max_steps = max_steps;
+    reset();
+}
+
+void GameClock::reset()
+{
+    m_source->reset();
+    m_previous_ns = m_source->get_time_ns();
+    m_accumulator_ns = 0;
+    m_step_start_ns = m_previous_ns;
+    m_dropped_ns = 0;
+}
+
+int GameClock::begin_frame()
+{
+    uint64_t now = m_source->get_time_ns();
+    m_accumulator_ns += now - m_previous_ns;
+    m_previous_ns = now;
+
+    uint64_t due = m_accumulator_ns / m_step_ns;
+    if (due > (uint64_t)m_max_steps)
+    {
+        // keep the part-step, so the frame still blends from the right place
+        uint64_t dropped = (due - m_max_steps) * m_step_ns;
+        m_accumulator_ns -= dropped;
+        m_dropped_ns += dropped;
+        due = m_max_steps;
+    }
+
+    m_step_start_ns = now - m_accumulator_ns;
+    return (int)due;
+}
+
+void GameClock::end_step()
+{
+    m_accumulator_ns -= m_step_ns;
+    m_step_start_ns += m_step_ns;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+const uint64_t NANOSECONDS_IN_SECOND = 1000000000;
+
+/**
+* Where the game gets the time from: whole nanoseconds since the source was
+* reset, which never go backwards. 64 bits of nanoseconds last centuries, and
+* unlike a float of seconds they are as precise after a month of uptime as after
+* a second.
+**/
+class TimeSource
+{
+public:
+    virtual ~TimeSource() {};
+
+    virtual void     reset() = 0;        // now is zero
+    virtual uint64_t get_time_ns() = 0;
+};
+
+// The real time, from the platform's high-resolution counter.
+class SystemTimeSource : public TimeSource
+{
+private:
+    uint64_t m_origin = 0;      // counter ticks at reset()
+    uint64_t m_frequency = 1;   // ticks per second
+
+public:
+    void     reset() override;
+    uint64_t get_time_ns() override;
+};
+
+// Time that only moves when it's told to: for offscreen recording, replays and tests.
+class VirtualTimeSource : public TimeSource
+{
+private:
+    uint64_t m_time_ns = 0;
+
+public:
+    void     reset() override { m_time_ns = 0; };
+    uint64_t get_time_ns() override { return m_time_ns; };
+
+    void advance(uint64_t delta_ns) { m_time_ns += delta_ns; };
+    void set_time_ns(uint64_t time_ns) { if (time_ns > m_time_ns) m_time_ns = time_ns; };
+};
+
+/**
+* Turns a TimeSource into fixed simulation steps: begin_frame() banks however long
+* the last frame took, and the simulation then runs one step for each whole step of
+* time in the bank, calling end_step() after each.
+*
+* All of it is integer nanoseconds, so the bank never drifts however long the game
+* runs. After a stall (a breakpoint, a slow disk, the window being dragged) at most
+* max_steps run in one frame and the rest of the backlog is written off; otherwise
+* a frame that took too long would queue up even more steps for the next one, and
+* the game would never catch up.
+**/
+class GameClock
+{
+private:
+    TimeSource* m_source = nullptr;
+    uint64_t    m_step_ns = 0;
+    int         m_max_steps = 0;
+
+    uint64_t m_previous_ns = 0;
+    uint64_t m_accumulator_ns = 0;   // time owed to the simulation, always less than a step between frames
+    uint64_t m_step_start_ns = 0;    // when the next step to run begins, on the source's clock
+    uint64_t m_dropped_ns = 0;       // written off in total
+
+public:
+    void load(TimeSource* source, uint64_t step_ns, int max_steps);
+
+    // restarts the source, with nothing owed
+    void reset();
+
+    // how many steps are due this frame; at most max_steps
+    int  begin_frame();
+    void end_step();
+
+    uint64_t const get_step_start_ns() const { return m_step_start_ns; };
+    uint64_t const get_step_end_ns()   const { return m_step_start_ns + m_step_ns; };
+    uint64_t const get_dropped_ns()    const { return m_dropped_ns; };
+
+    // how far into the next step the source's clock is, from 0 to 1
+    float const get_alpha() const { return (float)((double)m_accumulator_ns / (double)m_step_ns); };
+};
@@ -0,0 +1,162 @@
+#define GL_SILENCE_DEPRECATION
+
+#include <iostream>
+#include "HeadlessContext.h"
+
+#ifdef KERBAL_HEADLESS_EGL
+
+bool HeadlessContext::load()
+{
+    // STEP 1: Get a display that isn't backed by any window system
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+    if (get_platform_display == NULL)
+    {
+        std::cout << "EGL_EXT_platform_base is not available" << std::endl;
+        return false;
+    }
+
+    m_display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, NULL, NULL))
+    {
+        std::cout << "Unable to initialise a surfaceless EGL display" << std::endl;
+        return false;
+    }
+
+    // STEP 2: Pick any config that can do our API; we never create a surface from it
+#ifdef KERBAL_GLES
+    const EGLenum api = EGL_OPENGL_ES_API;
+    const EGLint renderable_type = EGL_OPENGL_ES3_BIT;
+    const EGLint context_attributes[] =
+    {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 0,
+        EGL_NONE
+    };
+#else
+    const EGLenum api = EGL_OPENGL_API;
+    const EGLint renderable_type = EGL_OPENGL_BIT;
+    const EGLint context_attributes[] =
+    {
+        EGL_CONTEXT_MAJOR_VERSION,       3,
+        EGL_CONTEXT_MINOR_VERSION,       3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+#endif
+
+    const EGLint config_attributes[] =
+    {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, renderable_type,
+        EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint config_count = 0;
+    if (!eglChooseConfig(m_display, config_attributes, &config, 1, &config_count) || config_count == 0)
+    {
+        std::cout << "No EGL config supports the requested GL API" << std::endl;
+        return false;
+    }
+
+    // STEP 3: Create the context and make it current without any draw/read surface
+    eglBindAPI(api);
+    m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, context_attributes);
+
+    if (m_context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context))
+    {
+        std::cout << "Unable to make a surfaceless EGL context current" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool HeadlessContext::make_current()
+{
+    return eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context);
+}
+
+void HeadlessContext::release()
+{
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+void HeadlessContext::cleanup()
+{
+    if (m_display == EGL_NO_DISPLAY) return;
+
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_context != EGL_NO_CONTEXT) eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+
+    m_context = EGL_NO_CONTEXT;
+    m_display = EGL_NO_DISPLAY;
+}
+
+#else
+
+bool HeadlessContext::load()
+{
+    SDL_Init(SDL_INIT_VIDEO);
+
+#ifdef KERBAL_GLES
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+#else
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+#endif
+
+    // a 1x1 window that is never shown; it only exists to own the context
+    m_window = SDL_CreateWindow("Kerbal Landing (headless)",
+        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+        1, 1,
+        SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+
+    if (m_window == NULL)
+    {
+        std::cout << "Unable to create a hidden window for the headless context" << std::endl;
+        return false;
+    }
+
+    m_context = SDL_GL_CreateContext(m_window);
+    if (m_context == NULL || SDL_GL_MakeCurrent(m_window, m_context) != 0)
+    {
+        std::cout << "Unable to create the headless GL context" << std::endl;
+        return false;
+    }
+
+#ifdef _WINDOWS
+    glewExperimental = GL_TRUE;
+    glewInit();
+#endif
+
+    return true;
+}
+
+bool HeadlessContext::make_current()
+{
+    return SDL_GL_MakeCurrent(m_window, m_context) == 0;
+}
+
+void HeadlessContext::release()
+{
+    SDL_GL_MakeCurrent(m_window, NULL);
+}
+
+void HeadlessContext::cleanup()
+{
+    if (m_context != NULL) SDL_GL_DeleteContext(m_context);
+    if (m_window != NULL) SDL_DestroyWindow(m_window);
+
+    m_context = NULL;
+    m_window  = NULL;
+}
+
+#endif
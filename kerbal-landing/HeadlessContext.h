@@ -0,0 +1,39 @@
+#pragma once
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#ifdef KERBAL_HEADLESS_EGL
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+#endif
+
+/**
+* An OpenGL context with no on-screen surface, for rendering on machines that
+* have no display. With KERBAL_HEADLESS_EGL defined this is a surfaceless EGL
+* context (EGL_MESA_platform_surfaceless, works with llvmpipe/swrast); otherwise
+* it falls back to a hidden SDL window, which still needs a display server.
+* Either way nothing is ever presented, so all drawing must go to an FBO.
+**/
+class HeadlessContext
+{
+private:
+#ifdef KERBAL_HEADLESS_EGL
+    EGLDisplay m_display = EGL_NO_DISPLAY;
+    EGLContext m_context = EGL_NO_CONTEXT;
+#else
+    SDL_Window*   m_window  = nullptr;
+    SDL_GLContext m_context = nullptr;
+#endif
+
+public:
+    bool load();
+    void cleanup();
+
+    // hand the context between threads; it is current on the loading thread to begin with
+    bool make_current();
+    void release();
+};
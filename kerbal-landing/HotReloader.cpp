@@ -0,0 +1,197 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include "HotReloader.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
+
+void HotReloader::watch_texture(const char* path, GLuint texture_id, int hull_alpha)
+{
+    m_assets.push_back({ ASSET_TEXTURE, texture_id, hull_alpha, 0, { path, "" } });
+    m_asset_of_file.push_back((int)m_assets.size() - 1);
+    m_watcher.add(path);
+}
+
+void HotReloader::watch_shader(int shader, const char* vertex_path, const char* fragment_path)
+{
+    // either file changing rebuilds the whole program
+    m_assets.push_back({ ASSET_SHADER, 0, -1, shader, { vertex_path, fragment_path } });
+    m_asset_of_file.push_back((int)m_assets.size() - 1);
+    m_watcher.add(vertex_path);
+    m_asset_of_file.push_back((int)m_assets.size() - 1);
+    m_watcher.add(fragment_path);
+}
+
+void HotReloader::watch_level(const char* path)
+{
+    m_assets.push_back({ ASSET_LEVEL, 0, -1, 0, { path, "" } });
+    m_asset_of_file.push_back((int)m_assets.size() - 1);
+    m_watcher.add(path);
+}
+
+void HotReloader::start()
+{
+    m_watcher.start(on_file_changed, this);
+}
+
+void HotReloader::cleanup()
+{
+    m_watcher.cleanup();
+    m_assets.clear();
+    m_asset_of_file.clear();
+
+    m_ready_textures.clear();
+    m_ready_shaders.clear();
+    m_ready_hulls.clear();
+    if (m_ready_level != nullptr)
+    {
+        m_ready_level->cleanup();
+        delete m_ready_level;
+        m_ready_level = nullptr;
+    }
+}
+
+void HotReloader::on_file_changed(void* data, int id)
+{
+    HotReloader* reloader = (HotReloader*)data;
+    reloader->reload(reloader->m_assets[reloader->m_asset_of_file[id]]);
+}
+
+void HotReloader::reload(const Asset& asset)
+{
+    ALLOCATION_SCOPE(ALLOC_HOT_RELOAD);
+    PROFILE_ZONE("hot reload");
+    // watcher thread: everything slow happens here, outside the lock
+    std::cout << "Reloading " << asset.paths[0] << (asset.type == ASSET_SHADER ? " and " + asset.paths[1] : "") << std::endl;
+
+    switch (asset.type)
+    {
+    case ASSET_TEXTURE:
+    {
+        int width, height;
+        unsigned char* pixels = load_image_pixels(asset.paths[0].c_str(), &width, &height);
+        if (pixels == NULL)
+        {
+            std::cout << "Unable to reload image: " << asset.paths[0] << std::endl;
+            return;
+        }
+
+        TextureUpload upload;
+        upload.texture_id = asset.texture_id;
+        encode_texture(pixels, width, height, TEXTURE_AUTO, upload.data);
+
+        // an image with nothing opaque enough left in it keeps the old outline
+        ConvexHull hull;
+        bool traced = asset.hull_alpha >= 0 and build_alpha_hull(pixels, width, height, (unsigned char)asset.hull_alpha, hull);
+        if (asset.hull_alpha >= 0 and !traced) std::cout << "Unable to trace the outline of " << asset.paths[0] << "; keeping the old one" << std::endl;
+        free_image_pixels(pixels);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready_textures.push_back(std::move(upload));
+        if (traced)
+        {
+            // one that was never taken is out of date now
+            bool replaced = false;
+            for (auto& ready : m_ready_hulls)
+            {
+                if (ready.first != asset.texture_id) continue;
+                ready.second = std::move(hull);
+                replaced = true;
+            }
+            if (!replaced) m_ready_hulls.push_back({ asset.texture_id, std::move(hull) });
+        }
+        break;
+    }
+    case ASSET_SHADER:
+    {
+        // compiling needs the context, so only the sources are read here
+        ShaderReload shader_reload;
+        shader_reload.shader = asset.shader;
+        if (!read_text_file(asset.paths[0], shader_reload.vertex_source) or
+            !read_text_file(asset.paths[1], shader_reload.fragment_source))
+        {
+            std::cout << "Unable to reload shader: " << asset.paths[0] << ", " << asset.paths[1] << std::endl;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready_shaders.push_back(std::move(shader_reload));
+        break;
+    }
+    case ASSET_LEVEL:
+    {
+        // Level::load() reports what was wrong with it
+        Level* level = new Level();
+        if (!level->load(asset.paths[0].c_str()))
+        {
+            level->cleanup();
+            delete level;
+            return;
+        }
+
+        // one that was never taken is out of date now
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_ready_level != nullptr)
+        {
+            m_ready_level->cleanup();
+            delete m_ready_level;
+        }
+        m_ready_level = level;
+        break;
+    }
+    }
+}
+
+void HotReloader::collect(DrawList* list)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_ready_textures.empty() and m_ready_shaders.empty()) return;
+
+    for (TextureUpload& upload : m_ready_textures) list->uploads.push_back(std::move(upload));
+    for (ShaderReload& shader_reload : m_ready_shaders) list->shader_reloads.push_back(std::move(shader_reload));
+    m_ready_textures.clear();
+    m_ready_shaders.clear();
+}
+
+bool HotReloader::take_level(Level& level)
+{
+    Level* ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ready = m_ready_level;
+        m_ready_level = nullptr;
+    }
+    if (ready == nullptr) return false;
+
+    // the old level goes back with the loader's copy, and is released with it
+    level.swap(*ready);
+    ready->cleanup();
+    delete ready;
+    return true;
+}
+
+bool HotReloader::take_hull(GLuint texture_id, ConvexHull& hull)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_ready_hulls.begin(); it != m_ready_hulls.end(); ++it)
+    {
+        if (it->first != texture_id) continue;
+
+        hull = std::move(it->second);
+        m_ready_hulls.erase(it);
+        return true;
+    }
+    return false;
+}
+
+bool HotReloader::read_text_file(const std::string& path, std::string& contents)
+{
+    std::ifstream file(path);
+    if (file.fail()) return false;
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
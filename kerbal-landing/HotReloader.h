@@ -0,0 +1,73 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <utility>
+#include "FileWatcher.h"
+#include "RenderThread.h"
+#include "Texture.h"
+#include "Level.h"
+#include "Collision.h"
+
+/**
+* Reloads textures, shaders and the level while the game runs, as their files
+* change on disk, without touching anything that didn't.
+*
+* As much of each reload as can happen off the main thread does, on the watcher's
+* thread: images are decoded and encoded into their GPU format there, shader
+* sources read and levels parsed or mapped. What's left is handed over between
+* frames. collect() puts textures and shaders into the next DrawList, for the GL
+* thread to upload into the texture names that already exist and to relink before
+* it draws; take_level() swaps in a level that has finished loading, and
+* take_hull() the outline traced again from a texture that collides.
+*
+* Anything that fails to load is reported and the old version kept, so saving a
+* half-finished file never takes the game down.
+**/
+class HotReloader
+{
+private:
+    enum AssetType { ASSET_TEXTURE, ASSET_SHADER, ASSET_LEVEL };
+
+    struct Asset
+    {
+        AssetType   type;
+        GLuint      texture_id;      // textures
+        int         hull_alpha;      // textures: the outline's alpha threshold, or -1 for none
+        int         shader;          // shaders: the submitter's number for it
+        std::string paths[2];        // shaders have two; the rest only use the first
+    };
+
+    FileWatcher        m_watcher;
+    std::vector<Asset> m_assets;
+    std::vector<int>   m_asset_of_file;   // by FileWatcher id
+
+    // finished on the watcher's thread, waiting to be handed over
+    std::mutex                 m_mutex;
+    std::vector<TextureUpload> m_ready_textures;
+    std::vector<ShaderReload>  m_ready_shaders;
+    std::vector<std::pair<GLuint, ConvexHull>> m_ready_hulls;   // by texture name
+    Level*                     m_ready_level = nullptr;
+
+    static void on_file_changed(void* data, int id);
+    void        reload(const Asset& asset);
+    static bool read_text_file(const std::string& path, std::string& contents);
+
+public:
+    // before start() only
+    // with a hull_alpha, the image's outline is traced again at that threshold too
+    void watch_texture(const char* path, GLuint texture_id, int hull_alpha = -1);
+    void watch_shader(int shader, const char* vertex_path, const char* fragment_path);
+    void watch_level(const char* path);
+
+    void start();
+    void cleanup();
+
+    // simulation thread, between frames
+    void collect(DrawList* list);
+    bool take_level(Level& level);   // true if level was swapped for a newly loaded one
+    bool take_hull(GLuint texture_id, ConvexHull& hull);   // true if hull was replaced
+
+    bool const is_polling() const { return m_watcher.is_polling(); };
+};
@@ -0,0 +1,27 @@
+#include "InputRing.h"
+
+bool InputRing::push(const InputEvent& event)
+{
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == CAPACITY) return false;
+
+    m_events[head % CAPACITY] = event;
+
+    // the event must be written before the consumer can see the new head
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool InputRing::pop_before(uint64_t time_ns, InputEvent* event)
+{
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire)) return false;
+
+    const InputEvent& oldest = m_events[tail % CAPACITY];
+    if (oldest.timestamp_ns >= time_ns) return false;
+    *event = oldest;
+
+    // and read before the producer can reuse its slot
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// The player's controls, as opposed to keys: whatever is bound to them.
+enum InputControl : uint8_t { INPUT_ROTATE_LEFT, INPUT_ROTATE_RIGHT, INPUT_THRUST, INPUT_CONTROL_COUNT };
+
+struct InputEvent
+{
+    uint64_t     timestamp_ns;   // when it happened, on the same clock as the simulation
+    InputControl control;
+    bool         pressed;        // false = released
+};
+
+// Which controls are held, as of the last event applied.
+struct InputState
+{
+    bool held[INPUT_CONTROL_COUNT] = {};
+
+    void apply(const InputEvent& event) { held[event.control] = event.pressed; };
+};
+
+/**
+* A single-producer, single-consumer queue of input events with no locks: one
+* thread push()es, another pop()s, and each index is only ever written by its
+* own side. Events come out in the order they went in, which must also be
+* timestamp order.
+*
+* The simulation pops per fixed step, taking only the events stamped before the
+* step's end, so a key pressed halfway through a long frame affects the steps
+* after it rather than the whole frame, and how many frames are drawn makes no
+* difference to what the lander does.
+**/
+class InputRing
+{
+private:
+    static const uint32_t CAPACITY = 256;   // a power of two, so indices can wrap freely
+
+    InputEvent m_events[CAPACITY];
+
+    // on separate cache lines, so the two threads don't keep stealing each other's
+    alignas(64) std::atomic<uint32_t> m_head{ 0 };   // next to write; producer only
+    alignas(64) std::atomic<uint32_t> m_tail{ 0 };   // next to read; consumer only
+
+public:
+    // producer: false (and the event is dropped) when the ring is full
+    bool push(const InputEvent& event);
+
+    // consumer: the oldest event, if it happened before time_ns
+    bool pop_before(uint64_t time_ns, InputEvent* event);
+};
@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "InputSession.h"
+
+const uint64_t NANOSECONDS_IN_MILLISECOND = 1000000;
+
+const char* const EVENT_NAMES[] = { "press", "release", "restart", "end" };
+const char* const CONTROL_NAMES[INPUT_CONTROL_COUNT] = { "left", "right", "thrust" };
+
+static bool read_word(const char** text, char* word, size_t size)
+{
+    while (**text == ' ' or **text == '\t') (*text)++;
+    size_t length = strcspn(*text, " \t");
+    if (length == 0 or length >= size) return false;
+
+    memcpy(word, *text, length);
+    word[length] = '\0';
+    *text += length;
+    return true;
+}
+
+static int find_name(const char* word, const char* const* names, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(word, names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+bool InputSession::load(const char* filepath)
+{
+    clear();
+
+    FILE* file = fopen(filepath, "r");
+    if (file == NULL)
+    {
+        std::cout << "Unable to open input session: " << filepath << std::endl;
+        return false;
+    }
+
+    char line[256];
+    int line_number = 0;
+    bool ok = true;
+
+    while (ok and fgets(line, sizeof(line), file) != NULL)
+    {
+        line_number++;
+        line[strcspn(line, "#\r\n")] = '\0';
+
+        const char* text = line;
+        char time[32], type[16], control[16];
+        if (!read_word(&text, time, sizeof(time))) continue;
+
+        char* end;
+        uint64_t time_ms = strtoull(time, &end, 10);
+        int type_index = read_word(&text, type, sizeof(type)) ? find_name(type, EVENT_NAMES, 4) : -1;
+        ok = *end == '\0' and type_index >= 0;
+
+        SessionEvent event = { time_ms * NANOSECONDS_IN_MILLISECOND, (SessionEventType)type_index, INPUT_THRUST };
+        if (ok and (event.type == SESSION_PRESS or event.type == SESSION_RELEASE))
+        {
+            int control_index = read_word(&text, control, sizeof(control)) ? find_name(control, CONTROL_NAMES, INPUT_CONTROL_COUNT) : -1;
+            ok = control_index >= 0;
+            event.control = (InputControl)control_index;
+        }
+
+        // nothing may follow, so that a mistyped line isn't half read and taken as valid
+        while (*text == ' ' or *text == '\t') text++;
+        if (ok and *text != '\0')
+        {
+            std::cout << filepath << ":" << line_number << ": unexpected \"" << text << "\" after the event" << std::endl;
+            ok = false;
+            break;
+        }
+
+        if (ok and !m_events.empty() and event.time_ns < m_events.back().time_ns)
+        {
+            std::cout << filepath << ":" << line_number << ": events must be in time order" << std::endl;
+            ok = false;
+        }
+        else if (!ok) std::cout << filepath << ":" << line_number << ": can't understand \"" << line << "\"" << std::endl;
+
+        if (ok) m_events.push_back(event);
+    }
+
+    fclose(file);
+    return ok;
+}
+
+bool InputSession::save(const char* filepath) const
+{
+    FILE* file = fopen(filepath, "w");
+    if (file == NULL)
+    {
+        std::cout << "Unable to write input session: " << filepath << std::endl;
+        return false;
+    }
+
+    fprintf(file, "# kerbal-landing input session; times are milliseconds on the game clock\n");
+    for (const SessionEvent& event : m_events)
+    {
+        fprintf(file, "%-8llu %s", (unsigned long long)(event.time_ns / NANOSECONDS_IN_MILLISECOND), EVENT_NAMES[event.type]);
+        if (event.type == SESSION_PRESS or event.type == SESSION_RELEASE) fprintf(file, " %s", CONTROL_NAMES[event.control]);
+        fprintf(file, "\n");
+    }
+
+    return fclose(file) == 0;
+}
+
+void InputSession::clear()
+{
+    m_events.clear();
+    m_next = 0;
+}
+
+void InputSession::record(uint64_t time_ns, SessionEventType type, InputControl control)
+{
+    // key timestamps are only milliseconds apart; two in the same one can arrive either way round
+    if (!m_events.empty() and time_ns < m_events.back().time_ns) time_ns = m_events.back().time_ns;
+    m_events.push_back({ time_ns, type, control });
+}
+
+bool InputSession::next_due(uint64_t time_ns, SessionEvent* event)
+{
+    if (m_next >= m_events.size() or m_events[m_next].time_ns > time_ns) return false;
+    *event = m_events[m_next++];
+    return true;
+}
+
+uint64_t InputSession::get_end_ns() const
+{
+    for (const SessionEvent& event : m_events)
+    {
+        if (event.type == SESSION_END) return event.time_ns;
+    }
+    return m_events.empty() ? 0 : m_events.back().time_ns;
+}
+
+bool read_session_list(const char* filepath, std::vector<std::string>& paths)
+{
+    FILE* file = fopen(filepath, "r");
+    if (file == NULL)
+    {
+        std::cout << "Unable to open session list: " << filepath << std::endl;
+        return false;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        line[strcspn(line, "#\r\n")] = '\0';
+        const char* start = line + strspn(line, " \t");
+        size_t length = strlen(start);
+        while (length > 0 and (start[length - 1] == ' ' or start[length - 1] == '\t')) length--;
+        if (length > 0) paths.push_back(std::string(start, length));
+    }
+
+    fclose(file);
+    return true;
+}
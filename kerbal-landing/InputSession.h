@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "InputRing.h"
+
+enum SessionEventType { SESSION_PRESS, SESSION_RELEASE, SESSION_RESTART, SESSION_END };
+
+struct SessionEvent
+{
+    uint64_t         time_ns;   // on the game clock, from when it started
+    SessionEventType type;
+    InputControl     control;   // presses and releases only
+};
+
+/**
+* A recorded play session: every control pressed and released, every restart, and
+* when it stopped, so that it can be played back into the game without anyone at the
+* keyboard. Playback runs on the offscreen clock, which makes it deterministic: the
+* fixed steps only see input by its timestamp, never by how frames happened to fall.
+*
+* Sessions are kept as text, one event a line, so they can be written by hand too:
+*
+*     # comments run to the end of the line; times are milliseconds
+*     1200   press thrust
+*     1850   release thrust
+*     9000   restart
+*     20000  end
+*
+* with the controls named left, right and thrust. Events must be in time order.
+**/
+class InputSession
+{
+private:
+    std::vector<SessionEvent> m_events;
+    size_t                    m_next = 0;   // playback position
+
+public:
+    bool load(const char* filepath);
+    bool save(const char* filepath) const;
+
+    // ————— RECORDING ————— //
+    void clear();
+    void record(uint64_t time_ns, SessionEventType type, InputControl control = INPUT_THRUST);
+
+    // ————— PLAYBACK ————— //
+    void rewind() { m_next = 0; };
+
+    // the next event, if it is due by time_ns
+    bool next_due(uint64_t time_ns, SessionEvent* event);
+
+    // when the session ends; the last event's time if it was never ended
+    uint64_t get_end_ns() const;
+};
+
+// a list of session files, one a line, with # comments; for replaying a corpus of them
+bool read_session_list(const char* filepath, std::vector<std::string>& paths);
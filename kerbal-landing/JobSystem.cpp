@@ -0,0 +1,204 @@
+#include <string>
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
+
+// which of JobSystem::m_threads the current thread is; the loading thread is 0
+static thread_local int t_thread_index = 0;
+
+// ————— DEQUE ————— //
+
+bool WorkStealingDeque::push(Job* job)
+{
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top >= CAPACITY) return false;
+
+    m_jobs[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+
+    // publishes the job, and everything written to it, to thieves
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+Job* WorkStealingDeque::pop()
+{
+    // claim the bottom job first, then look at what thieves have taken meanwhile;
+    // seq_cst orders the two against a thief doing the same the other way round
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_seq_cst);
+
+    if (top > bottom)
+    {
+        // it was already empty
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = m_jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // the last job: a thief may be after it too, and whoever moves top wins it
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkStealingDeque::steal()
+{
+    int64_t top = m_top.load(std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load(std::memory_order_seq_cst);
+    if (top >= bottom) return nullptr;
+
+    Job* job = m_jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+    return job;
+}
+
+// ————— JOB SYSTEM ————— //
+
+void JobSystem::load(int worker_count)
+{
+    ALLOCATION_SCOPE(ALLOC_JOBS);
+    if (worker_count < 0) worker_count = (int)std::thread::hardware_concurrency() - 1;
+    if (worker_count < 0) worker_count = 0;
+
+    t_thread_index = 0;
+    for (int i = 0; i <= worker_count; i++) m_threads.push_back(new ThreadState());
+
+    m_running = true;
+    for (int i = 1; i <= worker_count; i++) m_workers.emplace_back(&JobSystem::worker_loop, this, i);
+}
+
+void JobSystem::cleanup()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) worker.join();
+    m_workers.clear();
+
+    for (ThreadState* thread : m_threads) delete thread;
+    m_threads.clear();
+}
+
+Job* JobSystem::find_job(int index)
+{
+    // our own newest job first, then the oldest of anyone else's
+    Job* job = m_threads[index]->deque.pop();
+    for (int i = 1; job == nullptr and i < (int)m_threads.size(); i++)
+    {
+        job = m_threads[(index + i) % m_threads.size()]->deque.steal();
+    }
+
+    if (job != nullptr) m_queued.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+Job* JobSystem::allocate_job()
+{
+    ThreadState* thread = m_threads[t_thread_index];
+    Job* job = &thread->jobs[thread->next_job];
+    thread->next_job = (thread->next_job + 1) % JOB_POOL_SIZE;
+
+    // the ring has come all the way round to a job nobody has picked up yet
+    while (job->in_use.load(std::memory_order_acquire))
+    {
+        Job* other = find_job(t_thread_index);
+        if (other != nullptr) execute(other);
+        else std::this_thread::yield();
+    }
+    return job;
+}
+
+void JobSystem::execute(Job* job)
+{
+    // copied out first, so the record can be reused while this one is still running
+    Job run;
+    run.function = job->function;
+    run.data = job->data;
+    run.begin = job->begin;
+    run.end = job->end;
+    run.counter = job->counter;
+    job->in_use.store(false, std::memory_order_release);
+
+    PROFILE_ZONE("job");
+    run.function(run.data, run.begin, run.end);
+
+    // everything the job wrote is visible to whoever sees the counter drop
+    run.counter->remaining.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::worker_loop(int index)
+{
+    t_thread_index = index;
+    Profiler::set_thread_name(("job worker " + std::to_string(index)).c_str());
+
+    while (m_running)
+    {
+        Job* job = find_job(index);
+        if (job != nullptr)
+        {
+            execute(job);
+            continue;
+        }
+
+        // nothing anywhere: sleep until parallel_for() queues more
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_wake.wait(lock, [this] { return !m_running or m_queued.load(std::memory_order_relaxed) > 0; });
+    }
+}
+
+void JobSystem::parallel_for(int count, int batch_size, JobFunction function, void* data, JobCounter* counter)
+{
+    if (count <= 0) return;
+
+    // no one to share with: skip the deque
+    if (m_workers.empty())
+    {
+        for (int begin = 0; begin < count; begin += batch_size)
+        {
+            function(data, begin, begin + batch_size < count ? begin + batch_size : count);
+        }
+        return;
+    }
+
+    ThreadState* thread = m_threads[t_thread_index];
+    int job_count = (count + batch_size - 1) / batch_size;
+    counter->remaining.fetch_add(job_count, std::memory_order_relaxed);
+
+    for (int begin = 0; begin < count; begin += batch_size)
+    {
+        Job* job = allocate_job();
+        job->function = function;
+        job->data = data;
+        job->begin = begin;
+        job->end = begin + batch_size < count ? begin + batch_size : count;
+        job->counter = counter;
+        job->in_use.store(true, std::memory_order_relaxed);
+
+        if (thread->deque.push(job)) m_queued.fetch_add(1, std::memory_order_relaxed);
+        else execute(job);
+    }
+
+    // the lock makes sure no worker is between checking m_queued and going to sleep
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    }
+    m_wake.notify_all();
+}
+
+void JobSystem::wait(JobCounter* counter)
+{
+    // help rather than block, so waiting inside a job can't starve the pool
+    while (counter->remaining.load(std::memory_order_acquire) > 0)
+    {
+        Job* job = find_job(t_thread_index);
+        if (job != nullptr) execute(job);
+        else std::this_thread::yield();
+    }
+}
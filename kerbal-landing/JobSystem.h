@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <cstdint>
+
+// A job works on items [begin, end) of whatever data points to.
+typedef void (*JobFunction)(void* data, int begin, int end);
+
+/**
+* How many jobs something is still waiting on. parallel_for() adds the jobs it
+* creates, each one takes itself off when it finishes, and JobSystem::wait()
+* returns once it reaches zero; whatever comes after depends on all of them.
+**/
+struct JobCounter
+{
+    std::atomic<int> remaining{ 0 };
+};
+
+struct Job
+{
+    JobFunction       function;
+    void*             data;
+    int               begin, end;
+    JobCounter*       counter;
+    std::atomic<bool> in_use{ false };   // until whoever runs it has copied it out
+};
+
+/**
+* A fixed-size Chase-Lev deque of jobs. Its owning thread pushes and pops at the
+* bottom, newest first, which keeps its own work hot in cache; any other thread
+* may steal from the top, oldest first, which takes the biggest remaining pieces.
+* Only steals and the owner's pop of the very last job contend, on one CAS.
+**/
+class WorkStealingDeque
+{
+private:
+    static const int64_t CAPACITY = 1024;   // a power of two
+
+    std::atomic<Job*> m_jobs[CAPACITY];
+    alignas(64) std::atomic<int64_t> m_top{ 0 };      // thieves take from here
+    alignas(64) std::atomic<int64_t> m_bottom{ 0 };   // the owner works here
+
+public:
+    bool push(Job* job);   // owner only; false when full
+    Job* pop();            // owner only
+    Job* steal();          // any thread; nullptr when empty, or when it lost a race
+};
+
+/**
+* A small pool of worker threads that share out jobs by work stealing.
+*
+* Each thread, the one that called load() included, has its own deque and pool
+* of Job records, so handing out work touches no locks and allocates nothing.
+* A thread with nothing to do steals from the others; one that is waiting on a
+* counter runs jobs instead of blocking, so jobs may themselves fan out and wait.
+*
+* Only the thread that called load(), and jobs, may hand out work. With no worker
+* threads at all, parallel_for() just runs everything inline.
+**/
+class JobSystem
+{
+private:
+    static const int JOB_POOL_SIZE = 1024;   // per thread; reused in a ring once each has been run
+
+    struct ThreadState
+    {
+        WorkStealingDeque deque;
+        Job               jobs[JOB_POOL_SIZE];
+        int               next_job = 0;
+    };
+
+    std::vector<std::thread>     m_workers;
+    std::vector<ThreadState*>    m_threads;   // [0] is the thread that called load()
+    std::atomic<bool>            m_running{ false };
+
+    // sleeping, for workers that have run out of jobs to steal
+    std::atomic<int>             m_queued{ 0 };
+    std::mutex                   m_sleep_mutex;
+    std::condition_variable      m_wake;
+
+    void worker_loop(int index);
+    Job* allocate_job();
+    Job* find_job(int index);
+    void execute(Job* job);
+
+public:
+    // worker_count < 0 = one per core, less the calling thread
+    void load(int worker_count);
+    void cleanup();
+
+    // splits [0, count) into jobs of at most batch_size items
+    void parallel_for(int count, int batch_size, JobFunction function, void* data, JobCounter* counter);
+    void wait(JobCounter* counter);
+
+    int const get_thread_count() const { return (int)m_threads.size(); };
+};
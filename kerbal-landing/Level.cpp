@@ -0,0 +1,370 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include "Level.h"
+#include "AllocationTracker.h"
+
+#ifdef _WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+// ————— COMPILED FORM ————— //
+// bump whenever LevelData's layout or meaning changes, so stale compiled levels are refused
+//  2: fuel_burn is per second rather than per step
+const uint32_t LEVEL_FORMAT_VERSION = 2;
+const char LEVEL_MAGIC[4] = { 'K', 'L', 'V', 'L' };
+
+struct LevelFileHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t data_size;    // sizeof(LevelData) when it was compiled
+    uint32_t reserved;     // keeps the data 16-byte aligned in the mapping
+};
+
+// ————— TEXT FORM ————— //
+enum LevelFieldType { FIELD_FLOAT, FIELD_INT, FIELD_UINT, FIELD_TERRAIN, FIELD_PATH };
+
+struct LevelField
+{
+    const char*    key;
+    LevelFieldType type;
+    size_t         offset;    // into LevelData
+    int            count;     // values on the line
+};
+
+const LevelField LEVEL_FIELDS[] = {
+    { "gravity",               FIELD_FLOAT,   offsetof(LevelData, gravity),               1 },
+    { "thruster_force",        FIELD_FLOAT,   offsetof(LevelData, thruster_force),        1 },
+    { "fuel",                  FIELD_FLOAT,   offsetof(LevelData, fuel),                  1 },
+    { "fuel_burn",             FIELD_FLOAT,   offsetof(LevelData, fuel_burn),             1 },
+    { "safe_speed",            FIELD_FLOAT,   offsetof(LevelData, safe_speed),            1 },
+    { "max_landing_angle",     FIELD_FLOAT,   offsetof(LevelData, max_landing_angle),     1 },
+    { "spawn_position",        FIELD_FLOAT,   offsetof(LevelData, spawn_position),        2 },
+    { "spawn_velocity",        FIELD_FLOAT,   offsetof(LevelData, spawn_velocity),        2 },
+    { "spawn_angle",           FIELD_FLOAT,   offsetof(LevelData, spawn_angle),           1 },
+    { "chunk_count",           FIELD_INT,     offsetof(LevelData, chunk_count),           1 },
+    { "terrain",               FIELD_TERRAIN, offsetof(LevelData, terrain),               1 },
+    { "seed",                  FIELD_UINT,    offsetof(LevelData, seed),                  1 },
+    { "pads_per_chunk",        FIELD_INT,     offsetof(LevelData, pads_per_chunk),        1 },
+    { "base_height",           FIELD_FLOAT,   offsetof(LevelData, base_height),           1 },
+    { "min_height",            FIELD_FLOAT,   offsetof(LevelData, min_height),            1 },
+    { "max_height",            FIELD_FLOAT,   offsetof(LevelData, max_height),            1 },
+    { "roughness",             FIELD_FLOAT,   offsetof(LevelData, roughness),             1 },
+    { "pad_flat_half_width",   FIELD_FLOAT,   offsetof(LevelData, pad_flat_half_width),   1 },
+    { "pad_ramp_width",        FIELD_FLOAT,   offsetof(LevelData, pad_ramp_width),        1 },
+    { "background",            FIELD_PATH,    offsetof(LevelData, background_path),       1 },
+    { "player",                FIELD_PATH,    offsetof(LevelData, player_path),           1 },
+    { "flame",                 FIELD_PATH,    offsetof(LevelData, flame_path),            1 },
+    { "landing_pad",           FIELD_PATH,    offsetof(LevelData, landing_pad_path),      1 },
+    { "terrain_pattern",       FIELD_PATH,    offsetof(LevelData, terrain_pattern),       1 },
+    { "terrain_fallback",      FIELD_PATH,    offsetof(LevelData, terrain_fallback_path), 1 },
+};
+const int LEVEL_FIELD_COUNT = sizeof(LEVEL_FIELDS) / sizeof(LEVEL_FIELDS[0]);
+
+// "pad x y" lines are a list rather than a field: the first one replaces the default pads
+const char PAD_KEY[] = "pad";
+
+static const char* skip_spaces(const char* text)
+{
+    while (*text == ' ' or *text == '\t') text++;
+    return text;
+}
+
+static bool parse_value(const LevelField& field, const char* text, LevelData& data)
+{
+    char* destination = (char*)&data + field.offset;
+
+    if (field.type == FIELD_PATH)
+    {
+        // the rest of the line, so paths may contain spaces
+        size_t length = strlen(text);
+        while (length > 0 and (text[length - 1] == ' ' or text[length - 1] == '\t')) length--;
+        if (length == 0 or length >= LEVEL_PATH_LENGTH) return false;
+
+        memcpy(destination, text, length);
+        destination[length] = '\0';
+        return true;
+    }
+
+    for (int i = 0; i < field.count; i++)
+    {
+        char* end;
+        switch (field.type)
+        {
+        case FIELD_FLOAT:
+            ((float*)destination)[i] = strtof(text, &end);
+            break;
+        case FIELD_INT:
+            ((int32_t*)destination)[i] = (int32_t)strtol(text, &end, 10);
+            break;
+        case FIELD_UINT:
+            ((uint32_t*)destination)[i] = (uint32_t)strtoul(text, &end, 10);
+            break;
+        default:  // FIELD_TERRAIN
+        {
+            size_t length = strcspn(text, " \t");
+            end = (char*)text + length;
+            if (length == strlen("procedural") and strncmp(text, "procedural", length) == 0) *(LevelTerrain*)destination = LEVEL_TERRAIN_PROCEDURAL;
+            else if (length == strlen("images") and strncmp(text, "images", length) == 0) *(LevelTerrain*)destination = LEVEL_TERRAIN_IMAGES;
+            else return false;
+            break;
+        }
+        }
+        if (end == text) return false;
+        text = skip_spaces(end);
+    }
+
+    return *text == '\0';
+}
+
+static bool is_index_pattern(const char* pattern)
+{
+    // exactly one %d, optionally zero-padded (%03d), and no other % at all, since
+    // the streaming thread hands the pattern to snprintf() as the format
+    int conversions = 0;
+    for (const char* c = pattern; *c != '\0'; c++)
+    {
+        if (*c != '%') continue;
+        c++;
+        while (*c >= '0' and *c <= '9') c++;
+        if (*c != 'd') return false;
+        conversions++;
+    }
+    return conversions == 1;
+}
+
+static bool validate(const LevelData& data, const char* filepath)
+{
+    const char* problem = NULL;
+    if (data.chunk_count < 1) problem = "chunk_count must be at least 1";
+    else if (data.pads_per_chunk < 1 or data.pads_per_chunk > LEVEL_MAX_PADS_PER_CHUNK) problem = "pads_per_chunk is out of range";
+    else if (data.image_pad_count < 0 or data.image_pad_count > LEVEL_MAX_PADS_PER_CHUNK) problem = "too many pads";
+    else if (data.min_height > data.max_height) problem = "min_height is above max_height";
+    else if (data.terrain != LEVEL_TERRAIN_PROCEDURAL and data.terrain != LEVEL_TERRAIN_IMAGES) problem = "terrain must be procedural or images";
+
+    // a compiled level's strings are used in place, so they had better end
+    const char* paths[] = { data.background_path, data.player_path, data.flame_path,
+                            data.landing_pad_path, data.terrain_pattern, data.terrain_fallback_path };
+    for (const char* path : paths)
+    {
+        if (memchr(path, '\0', LEVEL_PATH_LENGTH) == NULL) problem = "unterminated asset path";
+    }
+    if (problem == NULL and !is_index_pattern(data.terrain_pattern)) problem = "terrain_pattern needs exactly one %d and no other %";
+
+    if (problem != NULL)
+    {
+        std::cout << filepath << ": " << problem << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Level::parse(const char* filepath, LevelData& data)
+{
+    FILE* file = fopen(filepath, "r");
+    if (file == NULL)
+    {
+        std::cout << "Unable to open level: " << filepath << std::endl;
+        return false;
+    }
+
+    char line[512];
+    int line_number = 0;
+    bool pads_listed = false;
+    bool ok = true;
+
+    while (ok and fgets(line, sizeof(line), file) != NULL)
+    {
+        line_number++;
+        line[strcspn(line, "#\r\n")] = '\0';
+
+        const char* text = skip_spaces(line);
+        if (*text == '\0') continue;
+
+        size_t key_length = strcspn(text, " \t");
+        const char* value = skip_spaces(text + key_length);
+
+        if (key_length == strlen(PAD_KEY) and strncmp(text, PAD_KEY, key_length) == 0)
+        {
+            if (!pads_listed) data.image_pad_count = 0;
+            pads_listed = true;
+
+            LevelField pad = { PAD_KEY, FIELD_FLOAT, offsetof(LevelData, image_pads) + sizeof(glm::vec2) * data.image_pad_count, 2 };
+            ok = data.image_pad_count < LEVEL_MAX_PADS_PER_CHUNK and parse_value(pad, value, data);
+            if (ok) data.image_pad_count++;
+        }
+        else
+        {
+            const LevelField* field = NULL;
+            for (int i = 0; i < LEVEL_FIELD_COUNT; i++)
+            {
+                if (strlen(LEVEL_FIELDS[i].key) == key_length and strncmp(LEVEL_FIELDS[i].key, text, key_length) == 0) field = &LEVEL_FIELDS[i];
+            }
+            ok = field != NULL and parse_value(*field, value, data);
+        }
+
+        if (!ok) std::cout << filepath << ":" << line_number << ": can't understand \"" << text << "\"" << std::endl;
+    }
+
+    fclose(file);
+    return ok and validate(data, filepath);
+}
+
+bool Level::map(const char* filepath)
+{
+#ifdef _WINDOWS
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = GetFileSizeEx(file, &size) ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    CloseHandle(file);
+    if (mapping == NULL) return false;
+
+    // the view keeps the mapping alive on its own
+    m_mapping = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    m_mapping_size = (size_t)size.QuadPart;
+#else
+    int file = open(filepath, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat status;
+    m_mapping = nullptr;
+    if (fstat(file, &status) == 0)
+    {
+        m_mapping = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (m_mapping == MAP_FAILED) m_mapping = nullptr;
+        m_mapping_size = (size_t)status.st_size;
+    }
+    close(file);
+#endif
+
+    if (m_mapping == nullptr)
+    {
+        std::cout << "Unable to map level: " << filepath << std::endl;
+        return false;
+    }
+
+    const LevelFileHeader* header = (const LevelFileHeader*)m_mapping;
+    if (m_mapping_size < sizeof(LevelFileHeader) + sizeof(LevelData) or
+        header->version != LEVEL_FORMAT_VERSION or header->data_size != sizeof(LevelData))
+    {
+        std::cout << filepath << ": compiled by a different version of the game; compile it again" << std::endl;
+        cleanup();
+        return false;
+    }
+
+    m_mapped = (const LevelData*)(header + 1);
+    if (!validate(*m_mapped, filepath))
+    {
+        cleanup();
+        return false;
+    }
+    return true;
+}
+
+bool Level::load(const char* filepath)
+{
+    ALLOCATION_SCOPE(ALLOC_LEVEL);
+    cleanup();
+
+    char magic[sizeof(LEVEL_MAGIC)] = {};
+    FILE* file = fopen(filepath, "rb");
+    if (file == NULL)
+    {
+        std::cout << "Unable to open level: " << filepath << std::endl;
+        return false;
+    }
+    size_t magic_size = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+
+    if (magic_size == sizeof(magic) and memcmp(magic, LEVEL_MAGIC, sizeof(magic)) == 0) return map(filepath);
+    return parse(filepath, m_parsed);
+}
+
+void Level::cleanup()
+{
+    if (m_mapping != nullptr)
+    {
+#ifdef _WINDOWS
+        UnmapViewOfFile(m_mapping);
+#else
+        munmap(m_mapping, m_mapping_size);
+#endif
+    }
+
+    m_mapping = nullptr;
+    m_mapping_size = 0;
+    m_mapped = nullptr;
+    m_parsed = LevelData();
+}
+
+bool Level::compile(const char* text_filepath, const char* binary_filepath)
+{
+    ALLOCATION_SCOPE(ALLOC_LEVEL);
+    LevelData data;
+    if (!parse(text_filepath, data)) return false;
+
+    // zero the unused tails of the strings too, so the same text always compiles to the same bytes
+    LevelData output;
+    memset((void*)&output, 0, sizeof(output));
+    output = data;
+    char* paths[] = { output.background_path, output.player_path, output.flame_path,
+                      output.landing_pad_path, output.terrain_pattern, output.terrain_fallback_path };
+    for (char* path : paths)
+    {
+        size_t length = strlen(path);
+        memset(path + length, 0, LEVEL_PATH_LENGTH - length);
+    }
+    for (int i = output.image_pad_count; i < LEVEL_MAX_PADS_PER_CHUNK; i++) output.image_pads[i] = glm::vec2(0.0f);
+
+    LevelFileHeader header;
+    memcpy(header.magic, LEVEL_MAGIC, sizeof(header.magic));
+    header.version = LEVEL_FORMAT_VERSION;
+    header.data_size = sizeof(LevelData);
+    header.reserved = 0;
+
+    // written beside the target and renamed over it: a running game may have the old
+    // file mapped, and truncating that in place would pull the pages out from under it
+    std::string temporary_filepath = std::string(binary_filepath) + ".tmp";
+    FILE* file = fopen(temporary_filepath.c_str(), "wb");
+    if (file == NULL)
+    {
+        std::cout << "Unable to write level: " << binary_filepath << std::endl;
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 and fwrite(&output, sizeof(output), 1, file) == 1;
+    ok = fclose(file) == 0 and ok;
+
+#ifdef _WINDOWS
+    // rename() won't replace an existing file here
+    if (ok) remove(binary_filepath);
+#endif
+    if (ok) ok = rename(temporary_filepath.c_str(), binary_filepath) == 0;
+    if (!ok)
+    {
+        std::cout << "Unable to write level: " << binary_filepath << std::endl;
+        remove(temporary_filepath.c_str());
+    }
+    return ok;
+}
+
+void Level::swap(Level& other)
+{
+    std::swap(m_parsed, other.m_parsed);
+    std::swap(m_mapped, other.m_mapped);
+    std::swap(m_mapping, other.m_mapping);
+    std::swap(m_mapping_size, other.m_mapping_size);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "glm/vec2.hpp"
+
+const int LEVEL_PATH_LENGTH = 128;
+const int LEVEL_MAX_PADS_PER_CHUNK = 8;
+
+enum LevelTerrain : int32_t { LEVEL_TERRAIN_PROCEDURAL = 0, LEVEL_TERRAIN_IMAGES = 1 };
+
+/**
+* Everything that can differ from one level to the next. The defaults are the
+* original game, so a level file only has to give what it changes.
+*
+* This is plain data with a fixed layout on purpose: a compiled level is exactly
+* this struct, byte for byte, after a LevelFileHeader, and is used straight out of
+* the mapped file. Any change to the layout, or to what a field means, must
+* bump LEVEL_FORMAT_VERSION.
+**/
+struct LevelData
+{
+    // ————— PHYSICS ————— //
+    float gravity = -0.08f;
+    float thruster_force = 0.3f;
+    float fuel = 3000.0f;
+    float fuel_burn = 6.0f;              // per second with the thruster on
+    float safe_speed = 0.35f;            // landing any faster is a crash
+    float max_landing_angle = 25.0f;     // degrees either side of upright
+
+    // ————— SPAWN ————— //
+    glm::vec2 spawn_position = glm::vec2(-4.6f, 3.4f);
+    glm::vec2 spawn_velocity = glm::vec2(0.4f, 0.0f);
+    float     spawn_angle = -90.0f;
+
+    // ————— TERRAIN ————— //
+    int32_t      chunk_count = 16;
+    LevelTerrain terrain = LEVEL_TERRAIN_PROCEDURAL;
+    uint32_t     seed = 1;
+    int32_t      pads_per_chunk = 4;     // generated terrain only
+    float        base_height = -2.0f;    // generated terrain only, like everything down to pad_ramp_width
+    float        min_height = -3.4f;
+    float        max_height = 0.5f;
+    float        roughness = 1.0f;       // scales every noise octave
+    float        pad_flat_half_width = 0.45f;
+    float        pad_ramp_width = 0.3f;
+
+    // terrain images only: pad centres relative to the centre of every chunk
+    int32_t   image_pad_count = 4;
+    glm::vec2 image_pads[LEVEL_MAX_PADS_PER_CHUNK] = {
+        glm::vec2(-3.9f, -2.4f),
+        glm::vec2(1.55f, -2.35f),
+        glm::vec2(-1.9f, -0.95f),
+        glm::vec2(4.05f, -1.2f),
+    };
+
+    // ————— ASSETS ————— //
+    char background_path[LEVEL_PATH_LENGTH] = "assets/background.png";
+    char player_path[LEVEL_PATH_LENGTH] = "assets/kerbal_head.png";
+    char flame_path[LEVEL_PATH_LENGTH] = "assets/flame.png";
+    char landing_pad_path[LEVEL_PATH_LENGTH] = "assets/landing_pad.png";
+    char terrain_pattern[LEVEL_PATH_LENGTH] = "assets/terrain/chunk_%03d.png";  // one %d (or %03d) for the chunk index
+    char terrain_fallback_path[LEVEL_PATH_LENGTH] = "assets/terrain.png";        // for chunks with no image of their own
+};
+
+/**
+* A level, from either of its two forms:
+*
+*  - text: one "key value..." line per setting, # starts a comment. Unknown keys
+*    and malformed values are errors, reported with their line number. See
+*    levels/default.level for every key.
+*  - compiled: what compile() writes. load() maps the file and points into it, so
+*    there is no parsing and nothing is copied; the checks are on the header only.
+*
+* load() tells the two apart by the compiled form's magic number.
+**/
+class Level
+{
+private:
+    LevelData        m_parsed;              // a text level, or the defaults
+    const LevelData* m_mapped = nullptr;    // a compiled level, inside the mapping below
+    void*            m_mapping = nullptr;
+    size_t           m_mapping_size = 0;
+
+    static bool parse(const char* filepath, LevelData& data);
+    bool        map(const char* filepath);
+
+public:
+    bool load(const char* filepath);
+    void cleanup();
+
+    // trades levels, mapping and all; how a level loaded elsewhere replaces this one
+    void swap(Level& other);
+
+    const LevelData& get() const { return m_mapped != nullptr ? *m_mapped : m_parsed; };
+
+    // text level in, compiled level out
+    static bool compile(const char* text_filepath, const char* binary_filepath);
+};
@@ -0,0 +1,302 @@
+#define GL_SILENCE_DEPRECATION
+
+#include <cmath>
+#include <cstring>
+#include "ParticleSystem.h"
+#include "GLStats.h"
+#include "AllocationTracker.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define PARTICLES_USE_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+// what a particle does when it reaches the ground
+const float GROUND_BOUNCE = -0.3f;    // multiplies vertical velocity
+const float GROUND_FRICTION = 0.6f;   // multiplies horizontal velocity
+
+void ParticleSystem::load(int capacity, const char* vertex_shader_file, const char* fragment_shader_file)
+{
+    ALLOCATION_SCOPE(ALLOC_PARTICLES);
+    // round up so the SIMD loop can always read whole groups of 4 inside the pool
+    m_capacity = (capacity + 3) & ~3;
+    m_count = 0;
+
+    m_memory = new float[m_capacity * ARRAY_COUNT];
+    memset(m_memory, 0, sizeof(float) * m_capacity * ARRAY_COUNT);
+
+    m_x         = m_memory + m_capacity * 0;
+    m_y         = m_memory + m_capacity * 1;
+    m_vx        = m_memory + m_capacity * 2;
+    m_vy        = m_memory + m_capacity * 3;
+    m_life      = m_memory + m_capacity * 4;
+    m_life_rate = m_memory + m_capacity * 5;
+    m_tint      = m_memory + m_capacity * 6;
+
+    // no terrain until set_ground() says otherwise
+    m_ground_heights.assign(1, -1.0e30f);
+    m_ground_min_x = 0.0f;
+    m_ground_samples_per_unit = 0.0f;
+
+    // ————— RENDERING ————— //
+    m_program.load(vertex_shader_file, fragment_shader_file);
+
+    // the buffer holds four back-to-back arrays: x, y, life and tint
+    glGenVertexArrays(1, &m_vertex_array);
+    glGenBuffers(1, &m_vertex_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * m_capacity * 4, NULL, GL_STREAM_DRAW);
+
+    bind_attributes();
+}
+
+void ParticleSystem::bind_attributes()
+{
+    m_point_size_uniform = glGetUniformLocation(m_program.get_program_id(), "pointSize");
+
+    gl_bind_vertex_array(m_vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+
+    // the program may have been relinked, and its attributes moved
+    for (int i = 0; i < 4; i++)
+    {
+        if (m_attribute_locations[i] >= 0) gl_disable_vertex_attrib_array(m_attribute_locations[i]);
+    }
+
+    const char* attribute_names[] = { "particleX", "particleY", "life", "tint" };
+    for (int i = 0; i < 4; i++)
+    {
+        GLint location = glGetAttribLocation(m_program.get_program_id(), attribute_names[i]);
+        m_attribute_locations[i] = location;
+        if (location < 0) continue;
+
+        glVertexAttribPointer(location, 1, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(float) * m_capacity * i));
+        gl_enable_vertex_attrib_array(location);
+    }
+
+    gl_bind_vertex_array(0);
+}
+
+bool ParticleSystem::reload_shader(const std::string& vertex_source, const std::string& fragment_source)
+{
+    if (!m_program.reload(vertex_source, fragment_source)) return false;
+    bind_attributes();
+    return true;
+}
+
+void ParticleSystem::set_ground(const float* heights, int sample_count, float min_x, float max_x)
+{
+    m_ground_heights.assign(heights, heights + sample_count);
+    m_ground_min_x = min_x;
+    m_ground_samples_per_unit = sample_count / (max_x - min_x);
+}
+
+float ParticleSystem::random_unit()
+{
+    // xorshift32; deterministic, so replays produce the same exhaust
+    m_random_state ^= m_random_state << 13;
+    m_random_state ^= m_random_state >> 17;
+    m_random_state ^= m_random_state << 5;
+    return (m_random_state >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::emit(glm::vec2 position, glm::vec2 velocity, float spread_degrees, float speed_jitter,
+                          float lifetime, ParticleTint tint, int count)
+{
+    float speed = sqrtf(velocity.x * velocity.x + velocity.y * velocity.y);
+    float heading = atan2f(velocity.y, velocity.x);
+    float spread = spread_degrees * 3.14159265f / 180.0f;
+
+    for (int i = 0; i < count && m_count < m_capacity; i++)
+    {
+        float particle_heading = heading + (random_unit() - 0.5f) * spread;
+        float particle_speed = speed * (1.0f + (random_unit() * 2.0f - 1.0f) * speed_jitter);
+
+        m_x[m_count]         = position.x;
+        m_y[m_count]         = position.y;
+        m_vx[m_count]        = cosf(particle_heading) * particle_speed;
+        m_vy[m_count]        = sinf(particle_heading) * particle_speed;
+        m_life[m_count]      = 1.0f;
+        m_life_rate[m_count] = 1.0f / (lifetime * (0.75f + 0.5f * random_unit()));
+        m_tint[m_count]      = (float)tint;
+        m_count++;
+    }
+}
+
+// particles per job; a multiple of 4, so batches split the same way as the SIMD loop
+const int PARTICLE_BATCH_SIZE = 4096;
+
+struct ParticleBatch
+{
+    ParticleSystem* particles;
+    float delta_time, gravity, damping;
+};
+
+void ParticleSystem::update(float delta_time, float gravity, float drag, JobSystem* jobs)
+{
+    float damping = 1.0f - drag * delta_time;
+    if (damping < 0.0f) damping = 0.0f;
+
+    if (jobs != nullptr)
+    {
+        ParticleBatch batch = { this, delta_time, gravity, damping };
+        JobCounter counter;
+        jobs->parallel_for(m_count, PARTICLE_BATCH_SIZE, [](void* data, int begin, int end) {
+            ParticleBatch* batch = (ParticleBatch*)data;
+            batch->particles->integrate(begin, end, batch->delta_time, batch->gravity, batch->damping);
+        }, &batch, &counter);
+        jobs->wait(&counter);
+    }
+    else
+    {
+        integrate(0, m_count, delta_time, gravity, damping);
+    }
+
+    remove_dead();
+}
+
+void ParticleSystem::integrate(int begin, int end, float delta_time, float gravity, float damping)
+{
+    const float* ground = m_ground_heights.data();
+    float last_sample = (float)(m_ground_heights.size() - 1);
+    int i = begin;
+
+#ifdef PARTICLES_USE_SSE2
+    const __m128 delta_time4   = _mm_set1_ps(delta_time);
+    const __m128 gravity_step4 = _mm_set1_ps(gravity * delta_time);
+    const __m128 damping4      = _mm_set1_ps(damping);
+    const __m128 min_x4        = _mm_set1_ps(m_ground_min_x);
+    const __m128 per_unit4     = _mm_set1_ps(m_ground_samples_per_unit);
+    const __m128 last_sample4  = _mm_set1_ps(last_sample);
+    const __m128 zero4         = _mm_setzero_ps();
+    const __m128 bounce4       = _mm_set1_ps(GROUND_BOUNCE);
+    const __m128 friction4     = _mm_set1_ps(GROUND_FRICTION);
+
+    for (; i + 4 <= end; i += 4)
+    {
+        // STEP 1: Integrate
+        __m128 vx = _mm_mul_ps(_mm_loadu_ps(m_vx + i), damping4);
+        __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(m_vy + i), gravity_step4), damping4);
+        __m128 x  = _mm_add_ps(_mm_loadu_ps(m_x + i), _mm_mul_ps(vx, delta_time4));
+        __m128 y  = _mm_add_ps(_mm_loadu_ps(m_y + i), _mm_mul_ps(vy, delta_time4));
+        __m128 life = _mm_sub_ps(_mm_loadu_ps(m_life + i), _mm_mul_ps(_mm_loadu_ps(m_life_rate + i), delta_time4));
+
+        // STEP 2: Look up the ground under each lane (SSE2 has no gather, so do it by hand)
+        __m128 sample = _mm_mul_ps(_mm_sub_ps(x, min_x4), per_unit4);
+        sample = _mm_max_ps(zero4, _mm_min_ps(sample, last_sample4));
+        alignas(16) int index[4];
+        _mm_store_si128((__m128i*)index, _mm_cvttps_epi32(sample));
+        __m128 ground_y = _mm_setr_ps(ground[index[0]], ground[index[1]], ground[index[2]], ground[index[3]]);
+
+        // STEP 3: Anything below the ground is put back on it and bounces
+        __m128 below = _mm_cmplt_ps(y, ground_y);
+        y  = _mm_or_ps(_mm_and_ps(below, ground_y), _mm_andnot_ps(below, y));
+        vy = _mm_or_ps(_mm_and_ps(below, _mm_mul_ps(vy, bounce4)), _mm_andnot_ps(below, vy));
+        vx = _mm_or_ps(_mm_and_ps(below, _mm_mul_ps(vx, friction4)), _mm_andnot_ps(below, vx));
+
+        _mm_storeu_ps(m_x + i, x);
+        _mm_storeu_ps(m_y + i, y);
+        _mm_storeu_ps(m_vx + i, vx);
+        _mm_storeu_ps(m_vy + i, vy);
+        _mm_storeu_ps(m_life + i, life);
+    }
+#endif
+
+    // the scalar tail (or everything, without SSE2) does exactly the same
+    for (; i < end; i++)
+    {
+        m_vx[i] *= damping;
+        m_vy[i] = (m_vy[i] + gravity * delta_time) * damping;
+        m_x[i] += m_vx[i] * delta_time;
+        m_y[i] += m_vy[i] * delta_time;
+        m_life[i] -= m_life_rate[i] * delta_time;
+
+        float sample = (m_x[i] - m_ground_min_x) * m_ground_samples_per_unit;
+        sample = sample < 0.0f ? 0.0f : sample > last_sample ? last_sample : sample;
+        float ground_y = ground[(int)sample];
+
+        if (m_y[i] < ground_y)
+        {
+            m_y[i] = ground_y;
+            m_vy[i] *= GROUND_BOUNCE;
+            m_vx[i] *= GROUND_FRICTION;
+        }
+    }
+}
+
+void ParticleSystem::remove_dead()
+{
+    // swap-with-last keeps the live particles packed without shifting anything
+    int i = 0;
+    while (i < m_count)
+    {
+        if (m_life[i] > 0.0f)
+        {
+            i++;
+            continue;
+        }
+
+        int last = --m_count;
+        m_x[i]         = m_x[last];
+        m_y[i]         = m_y[last];
+        m_vx[i]        = m_vx[last];
+        m_vy[i]        = m_vy[last];
+        m_life[i]      = m_life[last];
+        m_life_rate[i] = m_life_rate[last];
+        m_tint[i]      = m_tint[last];
+    }
+}
+
+void ParticleSystem::render(DrawList* list) const
+{
+    // the list's buffer only ever grows, so this stops allocating once it's big enough
+    list->particle_count = m_count;
+    list->particle_data.resize(m_count * 4);
+
+    const float* arrays[] = { m_x, m_y, m_life, m_tint };
+    for (int i = 0; i < 4; i++)
+    {
+        memcpy(list->particle_data.data() + m_count * i, arrays[i], sizeof(float) * m_count);
+    }
+    list->add_particles();
+}
+
+void ParticleSystem::submit(const DrawList& list, const glm::mat4& projection_matrix, const glm::mat4& view_matrix, float point_size)
+{
+    int count = list.particle_count;
+    if (count == 0) return;
+
+    m_program.set_projection_matrix(projection_matrix);
+    m_program.set_view_matrix(view_matrix);
+    gl_uniform_1f(m_point_size_uniform, point_size);
+
+#ifndef KERBAL_GLES
+    glEnable(GL_PROGRAM_POINT_SIZE);
+#endif
+
+    // orphan last frame's storage so the driver never has to wait for it, then
+    // upload only the live part of each array
+    gl_bind_vertex_array(m_vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * m_capacity * 4, NULL, GL_STREAM_DRAW);
+
+    for (int i = 0; i < 4; i++)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(float) * m_capacity * i, sizeof(float) * count,
+                        list.particle_data.data() + count * i);
+    }
+
+    gl_draw_arrays(GL_POINTS, 0, count);
+    gl_bind_vertex_array(0);
+}
+
+void ParticleSystem::cleanup()
+{
+    glDeleteBuffers(1, &m_vertex_buffer);
+    glDeleteVertexArrays(1, &m_vertex_array);
+    glDeleteProgram(m_program.get_program_id());
+
+    delete[] m_memory;
+    m_memory = nullptr;
+    m_count = 0;
+}
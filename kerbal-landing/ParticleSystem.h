@@ -0,0 +1,84 @@
+#pragma once
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+#include "RenderThread.h"
+#include "JobSystem.h"
+
+enum ParticleTint { TINT_EXHAUST = 0, TINT_DEBRIS = 1 };
+
+/**
+* Fixed-capacity pool of point particles, stored as structure-of-arrays.
+*
+* Everything is allocated once in load(); emit() never allocates and silently drops
+* particles when the pool is full. Live particles are always packed at the front of
+* the arrays (dead ones are swapped with the last live one), so update(), render()
+* and submit() only ever touch [0, count).
+*
+* update() integrates 4 particles per iteration with SSE2 when available: gravity,
+* linear drag, lifetime, and a bounce against a sampled terrain height table.
+* Given a JobSystem, it splits the pool into batches and integrates them in
+* parallel; particles don't interact, so the result is the same either way.
+* render() copies the live particles into a DrawList on the simulation thread, and
+* submit() draws that copy as GL_POINTS in a single call on the GL thread.
+**/
+class ParticleSystem
+{
+private:
+    int m_capacity = 0;
+    int m_count = 0;
+
+    // ————— PARTICLE DATA (SoA) ————— //
+    static const int ARRAY_COUNT = 7;
+    float* m_memory = nullptr;      // one block backing every array below
+    float* m_x = nullptr;
+    float* m_y = nullptr;
+    float* m_vx = nullptr;
+    float* m_vy = nullptr;
+    float* m_life = nullptr;        // 1 at birth, dead at 0
+    float* m_life_rate = nullptr;   // 1 / lifetime in seconds
+    float* m_tint = nullptr;        // ParticleTint, as a float so it uploads like the rest
+
+    // ————— TERRAIN ————— //
+    std::vector<float> m_ground_heights;   // evenly spaced samples of the surface height
+    float  m_ground_min_x = 0.0f;
+    float  m_ground_samples_per_unit = 0.0f;
+
+    unsigned int m_random_state = 0x2545F491u;
+
+    // ————— RENDERING ————— //
+    ShaderProgram m_program;
+    GLuint m_vertex_array = 0;
+    GLuint m_vertex_buffer = 0;
+    GLint  m_point_size_uniform = -1;
+    GLint  m_attribute_locations[4] = { -1, -1, -1, -1 };
+
+    void  bind_attributes();
+
+    float random_unit();
+    void  integrate(int begin, int end, float delta_time, float gravity, float damping);
+    void  remove_dead();
+
+public:
+    void load(int capacity, const char* vertex_shader_file, const char* fragment_shader_file);
+    void set_ground(const float* heights, int sample_count, float min_x, float max_x);
+
+    void emit(glm::vec2 position, glm::vec2 velocity, float spread_degrees, float speed_jitter,
+              float lifetime, ParticleTint tint, int count);
+    void update(float delta_time, float gravity, float drag, JobSystem* jobs = nullptr);
+    void render(DrawList* list) const;
+    void submit(const DrawList& list, const glm::mat4& projection_matrix, const glm::mat4& view_matrix, float point_size);
+    bool reload_shader(const std::string& vertex_source, const std::string& fragment_source);  // GL thread only
+    void clear() { m_count = 0; };
+    void cleanup();
+
+    int const get_count()    const { return m_count;    };
+    int const get_capacity() const { return m_capacity; };
+};
@@ -0,0 +1,335 @@
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <iostream>
+#include "ProceduralTerrain.h"
+
+#ifdef _WINDOWS
+    #include <direct.h>
+    #include <process.h>
+    #define make_directory(path) _mkdir(path)
+    #define get_process_id() _getpid()
+#else
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define make_directory(path) mkdir(path, 0755)
+    #define get_process_id() getpid()
+#endif
+
+// bump whenever the output for a given seed changes, so old cache entries stop matching
+const uint32_t GENERATOR_VERSION = 1;
+
+// ————— PROFILE ————— //
+// heights are around ProceduralTerrainParams::base_height, before roughness scales them
+struct Octave
+{
+    float spacing;    // distance between lattice points
+    float amplitude;
+};
+const Octave OCTAVES[] = {
+    { 2.5f, 1.0f  },  // hills
+    { 0.9f, 0.45f },  // ridges
+    { 0.3f, 0.12f },  // rubble
+};
+const int OCTAVE_COUNT = sizeof(OCTAVES) / sizeof(OCTAVES[0]);
+
+// ————— TEXTURE ————— //
+// matched to assets/terrain.png
+const unsigned char FILL_GREY = 0x52,
+                    RIM_GREY = 0x9f;
+const float RIM_PIXELS = 4.0f;
+
+// ————— CACHE FILES ————— //
+const char CACHE_MAGIC[4] = { 'K', 'L', 'T', 'C' };
+
+struct CacheHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint64_t key;
+    int32_t  index;
+    int32_t  pixel_width, pixel_height;
+    int32_t  sample_count;
+    int32_t  pad_count;
+    int32_t  run_count;    // the pixels are run-length encoded: mostly sky above and rock below
+};
+
+struct PixelRun
+{
+    uint32_t length;
+    uint32_t rgba;
+};
+
+// cache files this process has started writing, to tell their temporary names apart
+static std::atomic<unsigned> s_cache_writes{ 0 };
+
+static uint64_t mix(uint64_t z)
+{
+    // splitmix64's finaliser: every input bit affects every output bit
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static float hash_unit(uint32_t seed, uint32_t stream, int32_t value)
+{
+    // uniform in [0, 1), determined entirely by the three inputs
+    uint64_t h = mix(((uint64_t)seed << 32 | stream) ^ mix((uint64_t)(uint32_t)value));
+    return (h >> 40) * (1.0f / 16777216.0f);
+}
+
+static void hash_bytes(uint64_t* hash, const void* data, size_t size)
+{
+    // FNV-1a
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        *hash ^= bytes[i];
+        *hash *= 0x100000001b3ULL;
+    }
+}
+
+void ProceduralTerrainSource::load(uint32_t seed, const char* cache_directory, const ProceduralTerrainParams& params)
+{
+    m_seed = seed;
+    m_params = params;
+    m_cache_directory = cache_directory != NULL ? cache_directory : "";
+
+    // fine if it already exists; if it can't be made, writes fail and we just regenerate
+    if (!m_cache_directory.empty()) make_directory(m_cache_directory.c_str());
+}
+
+float ProceduralTerrainSource::get_natural_height(float x) const
+{
+    float height = m_params.base_height;
+    for (int octave = 0; octave < OCTAVE_COUNT; octave++)
+    {
+        // straight lines between random lattice heights keep the surface faceted
+        float lattice = x / OCTAVES[octave].spacing;
+        float cell = floorf(lattice);
+        float t = lattice - cell;
+
+        float left = hash_unit(m_seed, octave, (int32_t)cell) * 2.0f - 1.0f;
+        float right = hash_unit(m_seed, octave, (int32_t)cell + 1) * 2.0f - 1.0f;
+        height += (left * (1.0f - t) + right * t) * OCTAVES[octave].amplitude * m_params.roughness;
+    }
+    return height < m_params.min_height ? m_params.min_height : height > m_params.max_height ? m_params.max_height : height;
+}
+
+void ProceduralTerrainSource::generate(int index, float min_x, float chunk_width, float chunk_height, TerrainChunk& chunk) const
+{
+    // STEP 1: The natural profile, one sample per pixel column
+    int width = m_params.pixel_width;
+    float units_per_pixel = chunk_width / width;
+    chunk.heights.resize(width);
+    for (int x = 0; x < width; x++)
+    {
+        chunk.heights[x] = get_natural_height(min_x + (x + 0.5f) * units_per_pixel);
+    }
+
+    // STEP 2: Level a pad site somewhere inside each slot
+    float slot_width = chunk_width / m_params.pads_per_chunk;
+    float reach = m_params.pad_flat_half_width + m_params.pad_ramp_width;
+    float freedom = slot_width - 2.0f * reach;
+    if (freedom < 0.0f) freedom = 0.0f;
+
+    for (int slot = 0; slot < m_params.pads_per_chunk; slot++)
+    {
+        float r = hash_unit(m_seed, OCTAVE_COUNT + slot, index);
+        float pad_x = min_x + slot * slot_width + (slot_width - freedom) / 2.0f + r * freedom;
+        float pad_height = get_natural_height(pad_x);
+
+        int first = (int)((pad_x - reach - min_x) / units_per_pixel);
+        int last = (int)((pad_x + reach - min_x) / units_per_pixel);
+        for (int x = first < 0 ? 0 : first; x <= last and x < width; x++)
+        {
+            float distance = fabsf(min_x + (x + 0.5f) * units_per_pixel - pad_x);
+            if (distance <= m_params.pad_flat_half_width)
+            {
+                chunk.heights[x] = pad_height;
+            }
+            else if (distance < reach)
+            {
+                float t = (distance - m_params.pad_flat_half_width) / m_params.pad_ramp_width;
+                chunk.heights[x] = pad_height + (chunk.heights[x] - pad_height) * t;
+            }
+        }
+
+        chunk.pads.push_back(glm::vec3(pad_x, pad_height + m_params.pad_centre_offset, 0.0f));
+    }
+
+    // STEP 3: Draw it
+    rasterise(chunk_height, chunk);
+}
+
+void ProceduralTerrainSource::rasterise(float chunk_height, TerrainChunk& chunk) const
+{
+    int width = m_params.pixel_width;
+    int height = m_params.pixel_height;
+    float pixels_per_unit = height / chunk_height;
+    float top_y = chunk_height / 2.0f;
+
+    chunk.pixel_width = width;
+    chunk.pixel_height = height;
+    chunk.pixels.assign(width * height * 4, 0);
+
+    for (int x = 0; x < width; x++)
+    {
+        float surface_row = (top_y - chunk.heights[x]) * pixels_per_unit;
+        int first_row = (int)surface_row;
+        if (first_row < 0) first_row = 0;
+
+        for (int y = first_row; y < height; y++)
+        {
+            // depth of this pixel's centre below the surface; the first pixel is
+            // partially covered, which antialiases the edge
+            float depth = y + 0.5f - surface_row;
+            float coverage = depth + 0.5f;
+            if (coverage <= 0.0f) continue;
+            if (coverage > 1.0f) coverage = 1.0f;
+
+            unsigned char grey = depth < RIM_PIXELS ? RIM_GREY : FILL_GREY;
+            unsigned char* pixel = &chunk.pixels[(y * width + x) * 4];
+            pixel[0] = pixel[1] = pixel[2] = grey;
+            pixel[3] = (unsigned char)(coverage * 255.0f);
+        }
+    }
+}
+
+uint64_t ProceduralTerrainSource::get_cache_key(int index, float min_x, float chunk_width, float chunk_height) const
+{
+    uint64_t key = 0xcbf29ce484222325ULL;
+    hash_bytes(&key, &GENERATOR_VERSION, sizeof(GENERATOR_VERSION));
+    hash_bytes(&key, &m_seed, sizeof(m_seed));
+    hash_bytes(&key, &index, sizeof(index));
+    hash_bytes(&key, &min_x, sizeof(min_x));
+    hash_bytes(&key, &chunk_width, sizeof(chunk_width));
+    hash_bytes(&key, &chunk_height, sizeof(chunk_height));
+    hash_bytes(&key, &m_params.base_height, sizeof(m_params.base_height));
+    hash_bytes(&key, &m_params.min_height, sizeof(m_params.min_height));
+    hash_bytes(&key, &m_params.max_height, sizeof(m_params.max_height));
+    hash_bytes(&key, &m_params.roughness, sizeof(m_params.roughness));
+    hash_bytes(&key, &m_params.pads_per_chunk, sizeof(m_params.pads_per_chunk));
+    hash_bytes(&key, &m_params.pad_flat_half_width, sizeof(m_params.pad_flat_half_width));
+    hash_bytes(&key, &m_params.pad_ramp_width, sizeof(m_params.pad_ramp_width));
+    hash_bytes(&key, &m_params.pad_centre_offset, sizeof(m_params.pad_centre_offset));
+    hash_bytes(&key, &m_params.pixel_width, sizeof(m_params.pixel_width));
+    hash_bytes(&key, &m_params.pixel_height, sizeof(m_params.pixel_height));
+    return key;
+}
+
+std::string ProceduralTerrainSource::get_cache_path(uint64_t key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.chunk", (unsigned long long)key);
+    return m_cache_directory + name;
+}
+
+bool ProceduralTerrainSource::read_cache(uint64_t key, TerrainChunk& chunk) const
+{
+    FILE* file = fopen(get_cache_path(key).c_str(), "rb");
+    if (file == NULL) return false;
+
+    // anything unexpected (a truncated write, a hash collision) counts as a miss
+    CacheHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 and
+                 memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 and
+                 header.version == GENERATOR_VERSION and header.key == key and
+                 header.pixel_width == m_params.pixel_width and header.pixel_height == m_params.pixel_height and
+                 header.sample_count == m_params.pixel_width and header.pad_count == m_params.pads_per_chunk and
+                 header.run_count > 0;
+
+    std::vector<PixelRun> runs;
+    if (valid)
+    {
+        chunk.heights.resize(header.sample_count);
+        chunk.pads.resize(header.pad_count);
+        runs.resize(header.run_count);
+
+        valid = fread(chunk.heights.data(), sizeof(float), header.sample_count, file) == (size_t)header.sample_count and
+                fread(chunk.pads.data(), sizeof(glm::vec3), header.pad_count, file) == (size_t)header.pad_count and
+                fread(runs.data(), sizeof(PixelRun), header.run_count, file) == (size_t)header.run_count;
+    }
+    fclose(file);
+
+    if (valid)
+    {
+        size_t pixel_count = (size_t)header.pixel_width * header.pixel_height;
+        chunk.pixels.resize(pixel_count * 4);
+        uint32_t* pixels = (uint32_t*)chunk.pixels.data();
+
+        size_t written = 0;
+        for (const PixelRun& run : runs)
+        {
+            if (written + run.length > pixel_count) break;
+            for (uint32_t i = 0; i < run.length; i++) pixels[written++] = run.rgba;
+        }
+
+        valid = written == pixel_count;
+        chunk.pixel_width = header.pixel_width;
+        chunk.pixel_height = header.pixel_height;
+    }
+
+    if (!valid)
+    {
+        chunk.heights.clear();
+        chunk.pads.clear();
+        chunk.pixels.clear();
+    }
+    return valid;
+}
+
+void ProceduralTerrainSource::write_cache(uint64_t key, const TerrainChunk& chunk) const
+{
+    std::vector<PixelRun> runs;
+    const uint32_t* pixels = (const uint32_t*)chunk.pixels.data();
+    size_t pixel_count = (size_t)chunk.pixel_width * chunk.pixel_height;
+    for (size_t i = 0; i < pixel_count; i++)
+    {
+        if (!runs.empty() and runs.back().rgba == pixels[i]) runs.back().length++;
+        else runs.push_back({ 1, pixels[i] });
+    }
+
+    CacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = GENERATOR_VERSION;
+    header.key = key;
+    header.index = chunk.index;
+    header.pixel_width = chunk.pixel_width;
+    header.pixel_height = chunk.pixel_height;
+    header.sample_count = (int32_t)chunk.heights.size();
+    header.pad_count = (int32_t)chunk.pads.size();
+    header.run_count = (int32_t)runs.size();
+
+    // write under a private name and rename into place, so nobody sharing the
+    // directory ever reads a half-written chunk; the process id and a count of
+    // writes keep the name apart from every other writer, in this process or not
+    std::string path = get_cache_path(key);
+    std::string temporary_path = path + "." + std::to_string(get_process_id()) + "." + std::to_string(s_cache_writes++) + ".tmp";
+
+    FILE* file = fopen(temporary_path.c_str(), "wb");
+    if (file == NULL) return;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 and
+                   fwrite(chunk.heights.data(), sizeof(float), chunk.heights.size(), file) == chunk.heights.size() and
+                   fwrite(chunk.pads.data(), sizeof(glm::vec3), chunk.pads.size(), file) == chunk.pads.size() and
+                   fwrite(runs.data(), sizeof(PixelRun), runs.size(), file) == runs.size();
+    fclose(file);
+
+    // rename fails on Windows if another instance got there first, which is fine
+    if (!written or rename(temporary_path.c_str(), path.c_str()) != 0) remove(temporary_path.c_str());
+}
+
+bool ProceduralTerrainSource::load_chunk(int index, float min_x, float chunk_width, float chunk_height, TerrainChunk& chunk)
+{
+    if (m_params.pads_per_chunk < 1 or m_params.pixel_width < 1 or m_params.pixel_height < 1) return false;
+
+    uint64_t key = get_cache_key(index, min_x, chunk_width, chunk_height);
+    bool caching = !m_cache_directory.empty();
+    if (caching and read_cache(key, chunk)) return true;
+
+    generate(index, min_x, chunk_width, chunk_height, chunk);
+    if (caching) write_cache(key, chunk);
+    return true;
+}
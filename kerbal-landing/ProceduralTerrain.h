@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include "TerrainStreamer.h"
+
+/**
+* Everything about a generated world other than its seed. Part of every cache key,
+* so changing any of it can never serve stale chunks.
+**/
+struct ProceduralTerrainParams
+{
+    float base_height = -2.0f;           // world units; chunks span y = -3.75 to 3.75
+    float min_height = -3.4f,            // the profile is clamped to this range
+          max_height = 0.5f;
+    float roughness = 1.0f;              // scales every noise octave
+
+    int   pads_per_chunk = 4;
+    float pad_flat_half_width = 0.45f;   // ground levelled either side of a pad's centre
+    float pad_ramp_width = 0.3f;         // then blended back into the natural profile
+    float pad_centre_offset = -0.05f;    // pad entity centre relative to the levelled ground
+
+    int   pixel_width = 800,             // texture size of one chunk
+          pixel_height = 600;
+};
+
+/**
+* Terrain generated from a seed: the same (seed, chunk) always gives the same
+* profile, pads and texture, and neighbouring chunks join seamlessly because the
+* profile is a function of world x rather than of the chunk.
+*
+* The profile is a sum of piecewise-linear value-noise octaves, which keeps the
+* faceted look of the hand-drawn terrain. Each chunk is split into equal slots and
+* one pad is levelled into a random spot inside each; the levelled ground never
+* reaches a slot's edge, so it can't disturb the chunk's neighbours.
+*
+* Generated chunks are written to a content-addressed cache: the file name is a
+* hash of the generator version, seed, the chunk's index and place in the world,
+* and the parameters, so repeat runs (and other instances sharing the directory)
+* skip generation entirely.
+**/
+class ProceduralTerrainSource : public TerrainSource
+{
+private:
+    uint32_t                m_seed = 0;
+    std::string             m_cache_directory;  // empty = no caching
+    ProceduralTerrainParams m_params;
+
+    float get_natural_height(float x) const;
+    void  generate(int index, float min_x, float chunk_width, float chunk_height, TerrainChunk& chunk) const;
+    void  rasterise(float chunk_height, TerrainChunk& chunk) const;
+
+    uint64_t    get_cache_key(int index, float min_x, float chunk_width, float chunk_height) const;
+    std::string get_cache_path(uint64_t key) const;
+    bool        read_cache(uint64_t key, TerrainChunk& chunk) const;
+    void        write_cache(uint64_t key, const TerrainChunk& chunk) const;
+
+public:
+    void load(uint32_t seed, const char* cache_directory, const ProceduralTerrainParams& params);
+
+    bool load_chunk(int index, float min_x, float chunk_width, float chunk_height, TerrainChunk& chunk) override;
+
+    uint32_t const get_seed() const { return m_seed; };
+};
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Profiler.h"
+#include "AllocationTracker.h"
+
+// Every field is atomic only so that the exporter may read a slot while its thread
+// overwrites it; the stores are all relaxed, which on x86 is a plain move.
+struct ProfileEvent
+{
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<uint64_t>    start{ 0 };
+    std::atomic<uint64_t>    end{ 0 };
+};
+
+struct ProfileThreadBuffer
+{
+    ProfileEvent          events[Profiler::CAPACITY];
+    std::atomic<uint64_t> written{ 0 };   // zones ever recorded; the next goes in events[written % CAPACITY]
+    std::string           name;           // under s_threads_mutex
+    int                   id = 0;
+};
+
+std::atomic<bool> Profiler::s_enabled{ false };
+
+static std::mutex                        s_threads_mutex;
+static std::vector<ProfileThreadBuffer*> s_threads;
+static thread_local ProfileThreadBuffer* t_buffer = nullptr;
+static thread_local std::string          t_thread_name;    // kept until the thread's first zone
+static uint64_t                          s_origin_ticks = 0;   // the trace's time zero
+
+static float    s_frame_times[Profiler::FRAME_HISTORY];   // milliseconds, a ring
+static int      s_frame_count = 0;
+static uint64_t s_last_frame_ticks = 0;
+
+static ProfileThreadBuffer* get_thread_buffer()
+{
+    // a thread's first zone registers it, once; after that it never takes the lock
+    if (t_buffer != nullptr) return t_buffer;
+
+    ALLOCATION_SCOPE(ALLOC_PROFILER);
+    ProfileThreadBuffer* buffer = new ProfileThreadBuffer();
+    std::lock_guard<std::mutex> lock(s_threads_mutex);
+    buffer->id = (int)s_threads.size() + 1;
+    buffer->name = t_thread_name.empty() ? "thread " + std::to_string(buffer->id) : t_thread_name;
+    s_threads.push_back(buffer);
+
+    t_buffer = buffer;
+    return buffer;
+}
+
+void Profiler::set_enabled(bool enabled)
+{
+    if (enabled and s_origin_ticks == 0) s_origin_ticks = SDL_GetPerformanceCounter();
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::set_thread_name(const char* name)
+{
+    // no buffer yet: a thread that never records shouldn't cost one
+    t_thread_name = name;
+    if (t_buffer == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(s_threads_mutex);
+    t_buffer->name = name;
+}
+
+void Profiler::record(const char* name, uint64_t start_ticks, uint64_t end_ticks)
+{
+    ProfileThreadBuffer* buffer = get_thread_buffer();
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+
+    // pairs with the fence in write_chrome_trace(): an exporter that sees any of the
+    // stores below will also see written at index or later, and know the slot is being reused
+    std::atomic_thread_fence(std::memory_order_release);
+
+    ProfileEvent& event = buffer->events[index & (CAPACITY - 1)];
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start_ticks, std::memory_order_relaxed);
+    event.end.store(end_ticks, std::memory_order_relaxed);
+
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::write_chrome_trace(const char* filepath)
+{
+    struct Zone { const char* name; uint64_t start, end; };
+
+    FILE* file = fopen(filepath, "w");
+    if (file == NULL)
+    {
+        std::cout << "Unable to write trace: " << filepath << std::endl;
+        return false;
+    }
+
+    std::vector<std::pair<ProfileThreadBuffer*, std::string>> threads;
+    {
+        std::lock_guard<std::mutex> lock(s_threads_mutex);
+        for (ProfileThreadBuffer* buffer : s_threads) threads.push_back({ buffer, buffer->name });
+    }
+
+    double ticks_per_microsecond = (double)SDL_GetPerformanceFrequency() / 1.0e6;
+    bool first = true;
+    std::vector<Zone> zones;
+    fprintf(file, "{\"traceEvents\":[\n");
+
+    for (auto& [buffer, name] : threads)
+    {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", buffer->id, name.c_str());
+        first = false;
+
+        // copy out whatever the ring holds, then drop anything its thread may have
+        // started overwriting meanwhile
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t oldest = written > (uint64_t)CAPACITY ? written - CAPACITY : 0;
+        zones.clear();
+        for (uint64_t i = oldest; i < written; i++)
+        {
+            const ProfileEvent& event = buffer->events[i & (CAPACITY - 1)];
+            zones.push_back({ event.name.load(std::memory_order_relaxed),
+                              event.start.load(std::memory_order_relaxed),
+                              event.end.load(std::memory_order_relaxed) });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t written_after = buffer->written.load(std::memory_order_relaxed);
+
+        for (uint64_t i = oldest; i < written; i++)
+        {
+            if (i + CAPACITY <= written_after) continue;
+
+            const Zone& zone = zones[i - oldest];
+            if (zone.start < s_origin_ticks) continue;
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    zone.name, buffer->id,
+                    (zone.start - s_origin_ticks) / ticks_per_microsecond,
+                    (zone.end - zone.start) / ticks_per_microsecond);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
+
+void Profiler::mark_frame()
+{
+    uint64_t now = SDL_GetPerformanceCounter();
+    if (s_last_frame_ticks != 0)
+    {
+        double milliseconds = (double)(now - s_last_frame_ticks) * 1000.0 / SDL_GetPerformanceFrequency();
+        s_frame_times[s_frame_count++ % FRAME_HISTORY] = (float)milliseconds;
+    }
+    s_last_frame_ticks = now;
+}
+
+void Profiler::get_frame_percentiles(float* p50_ms, float* p95_ms, float* p99_ms)
+{
+    int count = std::min(s_frame_count, (int)FRAME_HISTORY);
+    if (count == 0)
+    {
+        *p50_ms = *p95_ms = *p99_ms = 0.0f;
+        return;
+    }
+
+    float sorted[FRAME_HISTORY];
+    std::copy(s_frame_times, s_frame_times + count, sorted);
+    std::sort(sorted, sorted + count);
+    *p50_ms = sorted[count * 50 / 100];
+    *p95_ms = sorted[std::min(count - 1, count * 95 / 100)];
+    *p99_ms = sorted[std::min(count - 1, count * 99 / 100)];
+}
+
+void Profiler::cleanup()
+{
+    s_enabled.store(false, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(s_threads_mutex);
+    for (ProfileThreadBuffer* buffer : s_threads) delete buffer;
+    s_threads.clear();
+    t_buffer = nullptr;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <SDL.h>
+#include <atomic>
+#include <cstdint>
+
+/**
+* A timeline profiler. PROFILE_ZONE("name") at the top of a scope times the rest
+* of it, and write_chrome_trace() exports every thread's zones as Chrome trace JSON,
+* which chrome://tracing and ui.perfetto.dev both open.
+*
+* Each thread records into a ring buffer of its own, so a zone costs two counter
+* reads and a handful of stores, with no locks and nothing shared between threads
+* but the write count, which only the exporter reads. Once a ring is full the
+* oldest zones are overwritten: a trace is always the last CAPACITY zones of each
+* thread. With the profiler disabled a zone is one relaxed load and a branch.
+*
+* Zone names must be string literals, or anything else that outlives the trace.
+*
+* Separately from zones, mark_frame() keeps the last FRAME_HISTORY frame times
+* for get_frame_percentiles(), whether or not zones are being recorded.
+**/
+class Profiler
+{
+public:
+    static const int CAPACITY = 1 << 16;   // zones kept per thread; a power of two
+    static const int FRAME_HISTORY = 256;
+
+    static void set_enabled(bool enabled);
+    static bool is_enabled() { return s_enabled.load(std::memory_order_relaxed); };
+
+    // names the calling thread in the trace; the name is copied
+    static void set_thread_name(const char* name);
+
+    // where a zone ends up; ticks are SDL_GetPerformanceCounter()'s
+    static void record(const char* name, uint64_t start_ticks, uint64_t end_ticks);
+
+    // safe to call while other threads go on recording; any zone being overwritten
+    // as it is copied is left out
+    static bool write_chrome_trace(const char* filepath);
+
+    // ————— FRAMES ————— //
+    // call once per frame, on one thread
+    static void mark_frame();
+    static void get_frame_percentiles(float* p50_ms, float* p95_ms, float* p99_ms);
+
+    // frees every thread's buffer; no thread may record after this
+    static void cleanup();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// Times the rest of the enclosing scope.
+class ProfileZone
+{
+private:
+    const char* m_name;
+    uint64_t    m_start;   // 0 = the profiler was off when the zone began
+
+public:
+    explicit ProfileZone(const char* name) : m_name(name), m_start(Profiler::is_enabled() ? SDL_GetPerformanceCounter() : 0) {};
+    ~ProfileZone() { if (m_start != 0) Profiler::record(m_name, m_start, SDL_GetPerformanceCounter()); };
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+#define PROFILE_JOIN_NAME(a, b) a##b
+#define PROFILE_ZONE_NAME(line) PROFILE_JOIN_NAME(profile_zone_, line)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_NAME(__LINE__)(name)
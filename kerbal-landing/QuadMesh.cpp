@@ -0,0 +1,42 @@
+#define GL_SILENCE_DEPRECATION
+
+#include "QuadMesh.h"
+#include "GLStats.h"
+
+void QuadMesh::load(GLuint position_attribute, GLuint tex_coordinate_attribute)
+{
+    // interleaved x, y, u, v; v runs top-down to match how stb_image hands us rows
+    const float vertices[] =
+    {
+        -0.5f, -0.5f,   0.0f, 1.0f,
+         0.5f, -0.5f,   1.0f, 1.0f,
+         0.5f,  0.5f,   1.0f, 0.0f,
+        -0.5f, -0.5f,   0.0f, 1.0f,
+         0.5f,  0.5f,   1.0f, 0.0f,
+        -0.5f,  0.5f,   0.0f, 0.0f,
+    };
+
+    glGenVertexArrays(1, &m_vertex_array);
+    gl_bind_vertex_array(m_vertex_array);
+
+    glGenBuffers(1, &m_vertex_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(position_attribute, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    gl_enable_vertex_attrib_array(position_attribute);
+    glVertexAttribPointer(tex_coordinate_attribute, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    gl_enable_vertex_attrib_array(tex_coordinate_attribute);
+}
+
+void QuadMesh::bind()
+{
+    gl_bind_vertex_array(m_vertex_array);
+}
+
+void QuadMesh::cleanup()
+{
+    gl_bind_vertex_array(0);
+    glDeleteBuffers(1, &m_vertex_buffer);
+    glDeleteVertexArrays(1, &m_vertex_array);
+}
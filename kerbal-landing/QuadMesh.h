@@ -0,0 +1,27 @@
+#pragma once
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+
+/**
+* The one piece of geometry every sprite in the game is drawn with: a unit quad
+* centred on the origin, uploaded once into a static VBO and described by a VAO.
+* Everything that differs between draws (model transform, atlas rectangle, texture)
+* goes through uniforms, so after load() no vertex data is ever sent again.
+**/
+class QuadMesh
+{
+private:
+    GLuint m_vertex_array = 0;
+    GLuint m_vertex_buffer = 0;
+
+public:
+    static const int VERTEX_COUNT = 6;
+
+    void load(GLuint position_attribute, GLuint tex_coordinate_attribute);
+    void bind();
+    void cleanup();
+};
@@ -0,0 +1,82 @@
+#include "RenderThread.h"
+#include "Profiler.h"
+
+void RenderThread::start(void (*acquire_context)(), void (*submit)(const DrawList& list),
+                         void (*release_context)(), bool lockstep)
+{
+    m_acquire_context = acquire_context;
+    m_submit = submit;
+    m_release_context = release_context;
+    m_lockstep = lockstep;
+    m_stopping = false;
+
+    m_thread = std::thread(&RenderThread::thread_loop, this);
+}
+
+DrawList& RenderThread::begin_frame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_back_ready)
+    {
+        // the GL thread never took the last frame; write over it, keeping its uploads
+        m_back_ready = false;
+    }
+    else
+    {
+        // this list just came back from the GL thread, which ran its uploads
+        m_back->uploads.clear();
+        m_back->shader_reloads.clear();
+    }
+
+    m_back->commands.clear();
+    m_back->particle_count = 0;
+    m_back->space = SPACE_SCREEN;
+    return *m_back;
+}
+
+void RenderThread::publish()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_back->sequence = ++m_sequence;
+    m_back_ready = true;
+    m_frame_published.notify_one();
+
+    if (m_lockstep) m_frame_taken.wait(lock, [this] { return !m_back_ready; });
+}
+
+void RenderThread::thread_loop()
+{
+    Profiler::set_thread_name("render");
+    m_acquire_context();
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_frame_published.wait(lock, [this] { return m_stopping || m_back_ready; });
+            if (!m_back_ready) break;
+
+            std::swap(m_front, m_back);
+            m_back_ready = false;
+            m_frame_taken.notify_one();
+        }
+
+        // the only thing touching the front list now is this thread
+        m_submit(*m_front);
+    }
+
+    m_release_context();
+}
+
+void RenderThread::stop()
+{
+    if (!m_thread.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_frame_published.notify_one();
+    m_thread.join();
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "glm/vec4.hpp"
+#include "Transform2D.h"
+#include "Texture.h"
+
+enum DrawSpace { SPACE_SCREEN, SPACE_WORLD };   // SPACE_WORLD scrolls with the camera
+enum DrawCommandType { DRAW_SPRITE, DRAW_PARTICLES };
+
+struct DrawCommand
+{
+    DrawCommandType type;
+    DrawSpace       space;
+    GLuint          texture_id;
+    glm::vec4       tex_rect;     // u, v, width, height
+    Transform2D     transform;
+};
+
+// Texels for a texture name that already exists; see TerrainStreamer for why.
+struct TextureUpload
+{
+    GLuint      texture_id;
+    TextureData data;
+};
+
+// New sources for a shader that changed on disk; which shader is up to whoever submits.
+struct ShaderReload
+{
+    int         shader;
+    std::string vertex_source;
+    std::string fragment_source;
+};
+
+/**
+* Everything the GL thread needs to draw one frame, and nothing it has to ask the
+* simulation for: once published it is never touched by the simulation again.
+**/
+struct DrawList
+{
+    uint64_t  sequence = 0;
+    float     camera_x = 0.0f;
+    DrawSpace space = SPACE_SCREEN;   // given to commands as they are added
+
+    std::vector<DrawCommand>   commands;
+    std::vector<TextureUpload> uploads;   // run before any command
+    std::vector<ShaderReload>  shader_reloads;   // likewise, and kept like uploads
+
+    // live particles, as four back-to-back arrays of particle_count: x, y, life, tint
+    std::vector<float> particle_data;
+    int                particle_count = 0;
+
+    void set_space(DrawSpace new_space) { space = new_space; };
+
+    void add_sprite(GLuint texture_id, const Transform2D& transform, glm::vec4 tex_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f))
+    {
+        commands.push_back({ DRAW_SPRITE, space, texture_id, tex_rect, transform });
+    };
+
+    void add_particles() { commands.push_back({ DRAW_PARTICLES, space, 0, glm::vec4(0.0f), Transform2D() }); };
+};
+
+/**
+* Owns the GL context and does all drawing on its own thread, so the simulation
+* never waits on the driver or on vsync.
+*
+* The two DrawLists are double-buffered: the simulation fills the back one while
+* the GL thread draws the front one, and they swap when the GL thread is ready for
+* more. If the simulation finishes another frame before that happens, it takes its
+* unclaimed back list again and overwrites it, so a slow GL thread just sees fewer,
+* newer frames. Texture uploads and shader reloads in a reclaimed list are kept,
+* never dropped.
+*
+* In lockstep mode (headless recording) publish() instead waits until the GL thread
+* has taken the frame, so every simulated frame is drawn exactly once.
+**/
+class RenderThread
+{
+private:
+    DrawList  m_lists[2];
+    DrawList* m_back = &m_lists[0];   // simulation side
+    DrawList* m_front = &m_lists[1];  // GL side
+    uint64_t  m_sequence = 0;
+
+    std::thread             m_thread;
+    std::mutex              m_mutex;
+    std::condition_variable m_frame_published;
+    std::condition_variable m_frame_taken;
+    bool m_back_ready = false;  // published but not yet taken
+    bool m_lockstep = false;
+    bool m_stopping = false;
+
+    void (*m_acquire_context)() = nullptr;
+    void (*m_submit)(const DrawList& list) = nullptr;
+    void (*m_release_context)() = nullptr;
+
+    void thread_loop();
+
+public:
+    // acquire/release make the GL context current on/off the calling thread; submit
+    // draws and presents one frame. All three are only ever called on the GL thread.
+    void start(void (*acquire_context)(), void (*submit)(const DrawList& list),
+               void (*release_context)(), bool lockstep);
+
+    // simulation thread only
+    DrawList& begin_frame();
+    void      publish();
+
+    // draws whatever was last published, then gives the context back
+    void stop();
+};
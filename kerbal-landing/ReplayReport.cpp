@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "ReplayReport.h"
+#include "Benchmark.h"
+
+// a slower median has to clear both of these to count
+const double TIME_TOLERANCE = 0.05;      // a fraction of the baseline's median
+const double NOISE_SIGMAS = 3.0;         // standard errors of the difference between the medians
+const double P95_TOLERANCE = 0.15;       // the tail is noisier still, so it only gets a relative limit
+const double DRAW_CALL_TOLERANCE = 0.01; // streamed terrain turns up a frame or two sooner or later
+const double ALLOCATION_TOLERANCE = 0.10;
+const double ALLOCATION_SLACK = 1.0;     // per frame, for sessions that allocate next to nothing
+
+// MAD to standard deviation, for normal data, and the median's standard error in those
+const double MAD_TO_SIGMA = 1.4826;
+const double MEDIAN_EFFICIENCY = 1.2533;
+
+void ReplayReport::add_context(const char* key, const std::string& value)
+{
+    m_context.push_back({ key, value });
+}
+
+static double percentile(const std::vector<double>& sorted, int percent)
+{
+    return sorted[std::min(sorted.size() - 1, sorted.size() * percent / 100)];
+}
+
+void ReplayReport::add(const std::string& session, std::vector<double>& frame_ms, int64_t draw_calls, int64_t allocations)
+{
+    ReplayResult result;
+    result.session = session;
+    result.frames = (int)frame_ms.size();
+    if (!frame_ms.empty())
+    {
+        std::sort(frame_ms.begin(), frame_ms.end());
+        result.median_ms = percentile(frame_ms, 50);
+        result.p95_ms = percentile(frame_ms, 95);
+        result.p99_ms = percentile(frame_ms, 99);
+
+        for (double& time : frame_ms) time = fabs(time - result.median_ms);
+        std::sort(frame_ms.begin(), frame_ms.end());
+        result.mad_ms = percentile(frame_ms, 50);
+
+        result.draw_calls = (double)draw_calls / result.frames;
+        result.allocations = (double)allocations / result.frames;
+    }
+    m_results.push_back(result);
+}
+
+void ReplayReport::print() const
+{
+    printf("%-32s %7s %10s %10s %10s %10s %10s %10s\n", "session", "frames", "median ms", "mad ms",
+           "p95 ms", "p99 ms", "draws", "allocs");
+    for (const ReplayResult& result : m_results)
+    {
+        printf("%-32s %7d %10.3f %10.3f %10.3f %10.3f %10.1f %10.1f\n", result.session.c_str(), result.frames,
+               result.median_ms, result.mad_ms, result.p95_ms, result.p99_ms, result.draw_calls, result.allocations);
+    }
+}
+
+bool ReplayReport::write_json(const char* filepath) const
+{
+    FILE* file = fopen(filepath, "w");
+    if (file == NULL)
+    {
+        std::cout << "Unable to write replay results: " << filepath << std::endl;
+        return false;
+    }
+
+    fprintf(file, "{\n  \"context\": {");
+    for (size_t i = 0; i < m_context.size(); i++)
+    {
+        fprintf(file, "%s\n    ", i == 0 ? "" : ",");
+        write_json_string(file, m_context[i].first);
+        fprintf(file, ": ");
+        write_json_string(file, m_context[i].second);
+    }
+    fprintf(file, "\n  },\n  \"sessions\": [");
+
+    // one session a line, which is what read_json() counts on
+    for (size_t i = 0; i < m_results.size(); i++)
+    {
+        const ReplayResult& result = m_results[i];
+        fprintf(file, "%s\n    { \"session\": ", i == 0 ? "" : ",");
+        write_json_string(file, result.session);
+        fprintf(file, ", \"frames\": %d, \"median_ms\": %.4f, \"mad_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, "
+                      "\"draw_calls\": %.3f, \"allocations\": %.3f }",
+                result.frames, result.median_ms, result.mad_ms, result.p95_ms, result.p99_ms,
+                result.draw_calls, result.allocations);
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    return fclose(file) == 0;
+}
+
+static bool read_json_number(const char* line, const char* key, double* value)
+{
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char* found = strstr(line, pattern);
+    if (found == NULL) return false;
+
+    char* end;
+    *value = strtod(found + strlen(pattern), &end);
+    return end != found + strlen(pattern);
+}
+
+static bool read_json_string(const char* line, const char* key, std::string& value)
+{
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+    const char* found = strstr(line, pattern);
+    if (found == NULL) return false;
+
+    value.clear();
+    for (const char* text = found + strlen(pattern); *text != '\0'; text++)
+    {
+        if (*text == '"') return true;
+        if (*text == '\\' and text[1] != '\0') text++;
+        value += *text;
+    }
+    return false;
+}
+
+bool ReplayReport::read_json(const char* filepath)
+{
+    FILE* file = fopen(filepath, "r");
+    if (file == NULL)
+    {
+        std::cout << "Unable to open replay results: " << filepath << std::endl;
+        return false;
+    }
+
+    m_results.clear();
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        ReplayResult result;
+        if (!read_json_string(line, "session", result.session)) continue;
+
+        double frames = 0.0;
+        bool ok = read_json_number(line, "frames", &frames) and
+                  read_json_number(line, "median_ms", &result.median_ms) and
+                  read_json_number(line, "mad_ms", &result.mad_ms) and
+                  read_json_number(line, "p95_ms", &result.p95_ms) and
+                  read_json_number(line, "p99_ms", &result.p99_ms) and
+                  read_json_number(line, "draw_calls", &result.draw_calls) and
+                  read_json_number(line, "allocations", &result.allocations);
+        if (!ok)
+        {
+            std::cout << filepath << ": can't understand the results for " << result.session << std::endl;
+            fclose(file);
+            return false;
+        }
+        result.frames = (int)frames;
+        m_results.push_back(result);
+    }
+
+    fclose(file);
+    return true;
+}
+
+static double median_standard_error(const ReplayResult& result)
+{
+    if (result.frames == 0) return 0.0;
+    return MEDIAN_EFFICIENCY * MAD_TO_SIGMA * result.mad_ms / sqrt((double)result.frames);
+}
+
+int ReplayReport::compare(const ReplayReport& baseline, int* session_count) const
+{
+    int regressions = 0;
+    *session_count = (int)m_results.size();
+    printf("%-32s %10s %10s %8s %10s %10s  %s\n", "session", "base ms", "now ms", "change",
+           "base draws", "now draws", "verdict");
+
+    for (const ReplayResult& result : m_results)
+    {
+        const ReplayResult* before = NULL;
+        for (const ReplayResult& candidate : baseline.m_results)
+        {
+            if (candidate.session == result.session) before = &candidate;
+        }
+        if (before == NULL)
+        {
+            printf("%-32s %10s %10.3f %8s %10s %10.1f  new\n", result.session.c_str(), "-", result.median_ms, "-", "-", result.draw_calls);
+            continue;
+        }
+
+        // ————— VERDICT ————— //
+        double difference = result.median_ms - before->median_ms;
+        double noise = NOISE_SIGMAS * sqrt(pow(median_standard_error(result), 2) + pow(median_standard_error(*before), 2));
+        std::string problems;
+        if (difference > TIME_TOLERANCE * before->median_ms and difference > noise) problems += " median";
+        if (result.p95_ms > before->p95_ms * (1.0 + P95_TOLERANCE)) problems += " p95";
+        if (result.draw_calls > before->draw_calls * (1.0 + DRAW_CALL_TOLERANCE)) problems += " draws";
+        if (result.allocations > before->allocations * (1.0 + ALLOCATION_TOLERANCE) + ALLOCATION_SLACK) problems += " allocations";
+        if (result.frames != before->frames) problems += " frames";   // the session played out differently
+
+        double change = before->median_ms > 0.0 ? 100.0 * difference / before->median_ms : 0.0;
+        printf("%-32s %10.3f %10.3f %+7.1f%% %10.1f %10.1f  %s\n", result.session.c_str(), before->median_ms,
+               result.median_ms, change, before->draw_calls, result.draw_calls,
+               problems.empty() ? "ok" : ("REGRESSED:" + problems).c_str());
+        if (!problems.empty()) regressions++;
+    }
+
+    // a session that stopped running (or stopped loading) can't be let off quietly
+    for (const ReplayResult& before : baseline.m_results)
+    {
+        bool found = false;
+        for (const ReplayResult& result : m_results)
+        {
+            if (result.session == before.session) found = true;
+        }
+        if (found) continue;
+
+        printf("%-32s %10.3f %10s %8s %10.1f %10s  missing\n", before.session.c_str(), before.median_ms, "-", "-", before.draw_calls, "-");
+        regressions++;
+        (*session_count)++;
+    }
+
+    return regressions;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// One session's run through the game, summarised.
+struct ReplayResult
+{
+    std::string session;
+    int         frames = 0;
+    double      median_ms = 0.0,     // simulation-thread frame times, GL waits included
+                mad_ms = 0.0,        // median absolute deviation from median_ms
+                p95_ms = 0.0,
+                p99_ms = 0.0;
+    double      draw_calls = 0.0,    // per frame
+                allocations = 0.0;   // per frame, on every thread; 0 unless tracking is built in
+};
+
+/**
+* Collects replay results, writes them out as JSON, reads back earlier ones as a
+* baseline, and says which sessions got worse.
+*
+* Frame times are noisy and nothing like normally distributed, so they are
+* compared by median, and a slower median only counts as a regression if it is
+* both a meaningful fraction slower and well outside what the two runs' spread
+* could explain. Draw calls only vary with when streamed terrain arrives, so
+* they get a very small allowance; allocations vary a little with the driver
+* too, so theirs is bigger.
+**/
+class ReplayReport
+{
+private:
+    std::vector<ReplayResult>                        m_results;
+    std::vector<std::pair<std::string, std::string>> m_context;   // what the numbers were measured on
+
+public:
+    void add_context(const char* key, const std::string& value);
+
+    // frame_ms is reordered
+    void add(const std::string& session, std::vector<double>& frame_ms, int64_t draw_calls, int64_t allocations);
+
+    void print() const;
+    bool write_json(const char* filepath) const;
+
+    // reads only what write_json() writes
+    bool read_json(const char* filepath);
+
+    // prints the comparison; returns how many sessions regressed, counting baseline
+    // sessions that weren't run at all, and sets session_count to how many there were
+    int compare(const ReplayReport& baseline, int* session_count) const;
+
+    const std::vector<ReplayResult>& get_results() const { return m_results; };
+};
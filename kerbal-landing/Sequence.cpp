@@ -0,0 +1,83 @@
+#include <algorithm>
+#include "Sequence.h"
+
+bool SequenceScheduler::earlier_wake(const Timer& a, const Timer& b)
+{
+    // std::push_heap keeps the greatest at the front, so "greater" here means sooner
+    if (a.wake_time != b.wake_time) return a.wake_time > b.wake_time;
+    return a.order > b.order;
+}
+
+void SequenceScheduler::resume(std::coroutine_handle<> handle)
+{
+    handle.resume();
+    if (!handle.done()) return;
+
+    // finished: it's suspended at its final point and nothing else refers to it
+    m_live.erase(std::find(m_live.begin(), m_live.end(), handle));
+    handle.destroy();
+}
+
+void SequenceScheduler::TimeAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    scheduler->m_timers.push_back({ scheduler->m_time + seconds, scheduler->m_next_order++, handle });
+    std::push_heap(scheduler->m_timers.begin(), scheduler->m_timers.end(), earlier_wake);
+}
+
+void SequenceScheduler::SignalAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    scheduler->m_signal_waits.push_back({ signal, handle });
+}
+
+void SequenceScheduler::start(Sequence sequence)
+{
+    // the scheduler owns it from here on
+    std::coroutine_handle<> handle = sequence.m_handle;
+    sequence.m_handle = nullptr;
+
+    m_live.push_back(handle);
+    resume(handle);
+}
+
+void SequenceScheduler::advance(float delta_time)
+{
+    m_time += delta_time;
+
+    while (!m_timers.empty() and m_timers.front().wake_time <= m_time)
+    {
+        std::pop_heap(m_timers.begin(), m_timers.end(), earlier_wake);
+        std::coroutine_handle<> handle = m_timers.back().handle;
+        m_timers.pop_back();
+
+        // may well wait again, which pushes a new timer
+        resume(handle);
+    }
+}
+
+void SequenceScheduler::fire(const SequenceSignal& signal)
+{
+    // take the waiters out first: a sequence that waits on the signal again once
+    // resumed is waiting for the next time it fires, not this one
+    std::vector<std::coroutine_handle<>> woken;
+    woken.swap(m_woken);   // reuses the last fire()'s memory, unless this is one fire() inside another
+    woken.clear();
+
+    size_t kept = 0;
+    for (const SignalWait& wait : m_signal_waits)
+    {
+        if (wait.signal == &signal) woken.push_back(wait.handle);
+        else m_signal_waits[kept++] = wait;
+    }
+    m_signal_waits.resize(kept);
+
+    for (std::coroutine_handle<> handle : woken) resume(handle);
+    m_woken.swap(woken);
+}
+
+void SequenceScheduler::clear()
+{
+    for (std::coroutine_handle<> handle : m_live) handle.destroy();
+    m_live.clear();
+    m_timers.clear();
+    m_signal_waits.clear();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <coroutine>
+#include <vector>
+#include <cstdint>
+
+class SequenceScheduler;
+
+/**
+* A timed game sequence, written as a C++20 coroutine that reads top to bottom:
+*
+*     Sequence ending(SequenceScheduler& scheduler)
+*     {
+*         co_await scheduler.wait_for(g_runEnded);
+*         co_await scheduler.wait_seconds(4.0f);
+*         g_gameIsRunning = false;
+*     }
+*
+* Nothing runs until SequenceScheduler::start() takes it. From then on it is
+* only ever resumed by the scheduler, when what it is waiting for happens, so a
+* sequence that is waiting costs nothing per step.
+**/
+class Sequence
+{
+public:
+    struct promise_type
+    {
+        Sequence get_return_object() { return Sequence(std::coroutine_handle<promise_type>::from_promise(*this)); };
+        std::suspend_always initial_suspend() noexcept { return {}; };
+        std::suspend_always final_suspend() noexcept { return {}; };   // the scheduler destroys it
+        void return_void() {};
+        void unhandled_exception() { throw; };
+    };
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+
+    friend class SequenceScheduler;
+
+public:
+    explicit Sequence(std::coroutine_handle<promise_type> handle) : m_handle(handle) {};
+    Sequence(Sequence&& other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; };
+    Sequence(const Sequence&) = delete;
+    Sequence& operator=(const Sequence&) = delete;
+    ~Sequence() { if (m_handle) m_handle.destroy(); };
+};
+
+// Something sequences can wait for; SequenceScheduler::fire() wakes them all.
+struct SequenceSignal
+{
+};
+
+/**
+* Runs sequences on simulated time. Waits on time go in a min-heap by wake-up
+* time, so advance() only looks at the earliest; waits on signals sit in a list
+* that only fire() looks at. Either way nothing is polled.
+**/
+class SequenceScheduler
+{
+private:
+    struct Timer
+    {
+        double                  wake_time;
+        uint64_t                order;      // ties wake in the order they were set
+        std::coroutine_handle<> handle;
+    };
+
+    struct SignalWait
+    {
+        const SequenceSignal*   signal;
+        std::coroutine_handle<> handle;
+    };
+
+    double                               m_time = 0.0;   // seconds of simulated time
+    uint64_t                             m_next_order = 0;
+    std::vector<Timer>                   m_timers;       // a heap; see earlier_wake()
+    std::vector<SignalWait>              m_signal_waits;
+    std::vector<std::coroutine_handle<>> m_live;         // every unfinished sequence
+    std::vector<std::coroutine_handle<>> m_woken;        // fire()'s scratch space
+
+    static bool earlier_wake(const Timer& a, const Timer& b);
+    void        resume(std::coroutine_handle<> handle);
+
+public:
+    struct TimeAwaiter
+    {
+        SequenceScheduler* scheduler;
+        float              seconds;
+
+        bool await_ready() const noexcept { return seconds <= 0.0f; };
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {};
+    };
+
+    struct SignalAwaiter
+    {
+        SequenceScheduler*    scheduler;
+        const SequenceSignal* signal;
+
+        bool await_ready() const noexcept { return false; };
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {};
+    };
+
+    // runs the sequence up to its first wait
+    void start(Sequence sequence);
+
+    // moves simulated time on, resuming every sequence whose wait is over
+    void advance(float delta_time);
+
+    // resumes every sequence waiting for signal
+    void fire(const SequenceSignal& signal);
+
+    // destroys every sequence, wherever it has got to
+    void clear();
+
+    TimeAwaiter   wait_seconds(float seconds)              { return { this, seconds }; };
+    SignalAwaiter wait_for(const SequenceSignal& signal)   { return { this, &signal }; };
+
+    double const get_time()           const { return m_time; };
+    int    const get_sequence_count() const { return (int)m_live.size(); };
+};
@@ -1,8 +1,21 @@
 #define GL_SILENCE_DEPRECATION
 
 #include "ShaderProgram.h"
+#include "Profiler.h"
+#include "GLStats.h"
+#include "AllocationTracker.h"
+
+// The shader files carry no #version line; the right one for the context is prepended
+// here, so the same sources compile for desktop core profile and for GLES 3.
+#ifdef KERBAL_GLES
+static const char GLSL_VERSION_HEADER[] = "#version 300 es\nprecision mediump float;\n";
+#else
+static const char GLSL_VERSION_HEADER[] = "#version 330 core\n";
+#endif
 
 void ShaderProgram::load(const char *vertex_shader_file, const char *fragment_shader_file) {
+    ALLOCATION_SCOPE(ALLOC_SHADERS);
+    PROFILE_ZONE("ShaderProgram::load");
     
     // create the vertex shader
     m_vertex_shader = load_shader_from_file(vertex_shader_file, GL_VERTEX_SHADER);
@@ -13,6 +26,8 @@ void ShaderProgram::load(const char *vertex_shader_file, const char *fragment_sh
     m_program_id = glCreateProgram();
     glAttachShader(m_program_id, m_vertex_shader);
     glAttachShader(m_program_id, m_fragment_shader);
+    glBindAttribLocation(m_program_id, POSITION_ATTRIBUTE, "position");
+    glBindAttribLocation(m_program_id, TEX_COORD_ATTRIBUTE, "texCoord");
     glLinkProgram(m_program_id);
     
     GLint link_success;
@@ -23,16 +38,63 @@ void ShaderProgram::load(const char *vertex_shader_file, const char *fragment_sh
         printf("Error linking shader program!\n");
     }
     
-    m_model_matrix_uniform      = glGetUniformLocation(m_program_id, "modelMatrix");
+    find_uniforms();
+}
+
+bool ShaderProgram::reload(const std::string &vertex_source, const std::string &fragment_source)
+{
+    ALLOCATION_SCOPE(ALLOC_SHADERS);
+    GLuint vertex_shader = load_shader_from_string(GLSL_VERSION_HEADER + vertex_source, GL_VERTEX_SHADER);
+    GLuint fragment_shader = load_shader_from_string(GLSL_VERSION_HEADER + fragment_source, GL_FRAGMENT_SHADER);
+
+    GLint vertex_success, fragment_success;
+    glGetShaderiv(vertex_shader, GL_COMPILE_STATUS, &vertex_success);
+    glGetShaderiv(fragment_shader, GL_COMPILE_STATUS, &fragment_success);
+
+    GLuint program_id = 0;
+    GLint link_success = GL_FALSE;
+    if (vertex_success == GL_TRUE and fragment_success == GL_TRUE)
+    {
+        program_id = glCreateProgram();
+        glAttachShader(program_id, vertex_shader);
+        glAttachShader(program_id, fragment_shader);
+        glBindAttribLocation(program_id, POSITION_ATTRIBUTE, "position");
+        glBindAttribLocation(program_id, TEX_COORD_ATTRIBUTE, "texCoord");
+        glLinkProgram(program_id);
+        glGetProgramiv(program_id, GL_LINK_STATUS, &link_success);
+    }
+
+    if (link_success == GL_FALSE)
+    {
+        // the compile log, if that's what failed, has already been printed
+        std::cout << "Shader reload failed; keeping the previous program." << std::endl;
+        glDeleteProgram(program_id);
+        glDeleteShader(vertex_shader);
+        glDeleteShader(fragment_shader);
+        return false;
+    }
+
+    cleanup();
+    m_program_id = program_id;
+    m_vertex_shader = vertex_shader;
+    m_fragment_shader = fragment_shader;
+    find_uniforms();
+    return true;
+}
+
+void ShaderProgram::find_uniforms()
+{
+    m_model_transform_uniform   = glGetUniformLocation(m_program_id, "modelTransform");
     m_projection_matrix_uniform = glGetUniformLocation(m_program_id, "projectionMatrix");
     m_view_matrix_uniform       = glGetUniformLocation(m_program_id, "viewMatrix");
     m_colour_uniform            = glGetUniformLocation(m_program_id, "color");
-    
-    m_position_attribute  = glGetAttribLocation(m_program_id, "position");
-    m_tex_coord_attribute = glGetAttribLocation(m_program_id, "texCoord");
-    
+    m_tex_rect_uniform          = glGetUniformLocation(m_program_id, "texRect");
+
+    // a new program starts with nothing uploaded, whatever the cache says
+    m_tex_rect[0] = m_tex_rect[1] = m_tex_rect[2] = m_tex_rect[3] = -1.0f;
+
     set_colour(1.0f, 1.0f, 1.0f, 1.0f);
-    
+    set_tex_rect(0.0f, 0.0f, 1.0f, 1.0f);
 }
 
 void ShaderProgram::cleanup()
@@ -56,7 +118,7 @@ GLuint ShaderProgram::load_shader_from_file(const std::string &shaderFile, GLenu
     buffer << infile.rdbuf();
     
     // Load the shader from the contents of the file
-    return load_shader_from_string(buffer.str(), type);
+    return load_shader_from_string(GLSL_VERSION_HEADER + buffer.str(), type);
 }
 
 GLuint ShaderProgram::load_shader_from_string(const std::string &shaderContents, GLenum type)
@@ -90,24 +152,39 @@ GLuint ShaderProgram::load_shader_from_string(const std::string &shaderContents,
 
 void ShaderProgram::set_colour(float red, float green, float blue, float alpha)
 {
-    glUseProgram(m_program_id);
-    glUniform4f(m_colour_uniform, red, green, blue, alpha);
+    gl_use_program(m_program_id);
+    gl_uniform_4f(m_colour_uniform, red, green, blue, alpha);
+}
+
+void ShaderProgram::set_tex_rect(float u, float v, float width, float height)
+{
+    // most consecutive draws are whole textures, so this usually uploads nothing
+    if (m_tex_rect[0] == u && m_tex_rect[1] == v && m_tex_rect[2] == width && m_tex_rect[3] == height) return;
+
+    m_tex_rect[0] = u;
+    m_tex_rect[1] = v;
+    m_tex_rect[2] = width;
+    m_tex_rect[3] = height;
+
+    gl_use_program(m_program_id);
+    gl_uniform_4fv(m_tex_rect_uniform, 1, m_tex_rect);
 }
 
 void ShaderProgram::set_view_matrix(const glm::mat4 &matrix)
 {
-    glUseProgram(m_program_id);
-    glUniformMatrix4fv(m_view_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    gl_use_program(m_program_id);
+    gl_uniform_matrix_4fv(m_view_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
 }
 
-void ShaderProgram::set_model_matrix(const glm::mat4 &matrix)
+void ShaderProgram::set_model_transform(const Transform2D &transform)
 {
-    glUseProgram(m_program_id);
-    glUniformMatrix4fv(m_model_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    // two vec3 rows, 6 floats per draw instead of a full 4x4
+    gl_use_program(m_program_id);
+    gl_uniform_3fv(m_model_transform_uniform, 2, &transform.a);
 }
 
 void ShaderProgram::set_projection_matrix(const glm::mat4 &matrix)
 {
-    glUseProgram(m_program_id);
-    glUniformMatrix4fv(m_projection_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    gl_use_program(m_program_id);
+    gl_uniform_matrix_4fv(m_projection_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
 }
@@ -10,6 +10,7 @@
 #include <fstream>
 #include <sstream>
 #include "glm/mat4x4.hpp"
+#include "Transform2D.h"
 
 class ShaderProgram
 {
@@ -18,32 +19,43 @@ private:
     
     GLuint load_shader_from_string(const std::string &shader_contents, GLenum shader_type);
     GLuint load_shader_from_file(const std::string &shader_file, GLenum shader_type);
+    void   find_uniforms();
 
     GLuint m_program_id;
 
     GLuint m_projection_matrix_uniform;
-    GLuint m_model_matrix_uniform;
+    GLuint m_model_transform_uniform;
     GLuint m_view_matrix_uniform;
     GLuint m_colour_uniform;
+    GLuint m_tex_rect_uniform;
 
-    GLuint m_position_attribute;
-    GLuint m_tex_coord_attribute;
+    float m_tex_rect[4] = { -1.0f, -1.0f, -1.0f, -1.0f };  // last uploaded, to skip repeats
 
     GLuint m_vertex_shader;
     GLuint m_fragment_shader;
     
 public:
+    // Attribute locations are fixed at link time so that one VAO works with every program
+    static const GLuint POSITION_ATTRIBUTE  = 0;
+    static const GLuint TEX_COORD_ATTRIBUTE = 1;
 
     void load(const char *vertex_shader_file, const char *fragment_shader_file);
 
-    void set_model_matrix(const glm::mat4 &matrix);
+    // Rebuilds the program from new sources, as read from the shader files. Anything
+    // that fails to compile or link is reported and the old program kept, so a typo
+    // never takes the game down. Uniforms go back to their defaults: the caller sets
+    // the matrices again. GL thread only.
+    bool reload(const std::string &vertex_source, const std::string &fragment_source);
+
+    void set_model_transform(const Transform2D &transform);
     void set_projection_matrix(const glm::mat4 &matrix);
     void set_view_matrix(const glm::mat4 &matrix);
     void set_colour(float red, float green, float blue, float alpha);
+    void set_tex_rect(float u, float v, float width, float height);
     
     GLuint const get_program_id()               const { return m_program_id;          };
-    GLuint const get_position_attribute()       const { return m_position_attribute;  };
-    GLuint const get_tex_coordinate_attribute() const { return m_tex_coord_attribute; };
+    GLuint const get_position_attribute()       const { return POSITION_ATTRIBUTE;  };
+    GLuint const get_tex_coordinate_attribute() const { return TEX_COORD_ATTRIBUTE; };
     
     void set_program_id(GLuint program_id)                         { m_program_id = program_id;                   };
 };
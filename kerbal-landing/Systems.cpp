@@ -0,0 +1,191 @@
+#include <cmath>
+#include "glm/common.hpp"
+#include "Systems.h"
+
+void store_previous_transforms(World& world)
+{
+    for (int i = 0; i < world.interpolations.size(); i++)
+    {
+        const Transform& transform = world.transforms.get(world.interpolations.entity_at(i));
+        Interpolation& interpolation = world.interpolations[i];
+
+        interpolation.previous_position = transform.position;
+        interpolation.previous_angle = transform.angle;
+        interpolation.valid = true;
+    }
+}
+
+static bool boxes_overlap(const Transform& a, const Transform& b)
+{
+    float x_distance = fabs(a.position.x - b.position.x) - ((a.scale.x + b.scale.x) / 2.0f);
+    float y_distance = fabs(a.position.y - b.position.y) - ((a.scale.y + b.scale.y) / 2.0f);
+
+    return x_distance < 0.0f && y_distance < 0.0f;
+}
+
+void resolve_collisions(World& world, EntityId entity, CollisionAxis axis)
+{
+    Transform& transform = world.transforms.get(entity);
+    Motion& motion = world.motions.get(entity);
+    Collider& collider = world.colliders.get(entity);
+
+    for (int i = 0; i < world.solids.size(); i++)
+    {
+        // STEP 1: For every solid we overlap...
+        const Transform& solid = world.transforms.get(world.solids.entity_at(i));
+        if (!boxes_overlap(transform, solid)) continue;
+
+        // STEP 2: Calculate the distance between its centre and our centre
+        //         and use that to calculate the amount of overlap between
+        //         both bodies.
+        int a = axis == AXIS_X ? 0 : 1;
+        float distance = fabs(transform.position[a] - solid.position[a]);
+        float overlap = fabs(distance - (transform.scale[a] / 2.0f) - (solid.scale[a] / 2.0f));
+
+        // STEP 3: "Unclip" ourselves from the other entity, and zero our
+        //         velocity along this axis.
+        if (motion.velocity[a] > 0) {
+            transform.position[a] -= overlap;
+            motion.velocity[a] = 0;
+            if (axis == AXIS_X) collider.collided_right = true;
+            else collider.collided_top = true;
+        }
+        else if (motion.velocity[a] < 0) {
+            transform.position[a] += overlap;
+            motion.velocity[a] = 0;
+            if (axis == AXIS_X) collider.collided_left = true;
+            else collider.collided_bottom = true;
+        }
+    }
+}
+
+void update_motion(World& world, float delta_time)
+{
+    for (int i = 0; i < world.motions.size(); i++)
+    {
+        EntityId entity = world.motions.entity_at(i);
+        Motion& motion = world.motions[i];
+        Transform& transform = world.transforms.get(entity);
+
+        Collider* collider = world.colliders.find(entity);
+        if (collider != nullptr) *collider = Collider();
+
+        motion.velocity += motion.acceleration * delta_time;
+
+        transform.position.y += motion.velocity.y * delta_time;
+        if (collider != nullptr) resolve_collisions(world, entity, AXIS_Y);
+
+        transform.position.x += motion.velocity.x * delta_time;
+        if (collider != nullptr) resolve_collisions(world, entity, AXIS_X);
+
+        transform.angle += motion.rotation * motion.rotation_speed * 45.0f * delta_time;
+        transform.dirty = true;
+    }
+}
+
+void update_animation(World& world, float delta_time)
+{
+    for (int i = 0; i < world.animations.size(); i++)
+    {
+        Animation& animation = world.animations[i];
+
+        if (animation.frame_count > 1)
+        {
+            animation.frame_time += delta_time;
+            if (animation.frame_time >= animation.seconds_per_frame)
+            {
+                animation.frame_time = 0.0f;
+                animation.frame = animation.first_frame +
+                                  (animation.frame - animation.first_frame + 1) % animation.frame_count;
+            }
+        }
+
+        // the shared quad has 0..1 texture coordinates; the shader maps them into this cell
+        Sprite& sprite = world.sprites.get(world.animations.entity_at(i));
+        sprite.tex_rect = glm::vec4(
+            (float)(animation.frame % animation.columns) / animation.columns,
+            (float)(animation.frame / animation.columns) / animation.rows,
+            1.0f / animation.columns,
+            1.0f / animation.rows);
+    }
+}
+
+static void update_transform_range(void* data, int begin, int end)
+{
+    World& world = *(World*)data;
+
+    // Gather the dirty transforms into SoA batches and recompose them in one pass each.
+    const int BATCH_SIZE = 64;
+    float x[BATCH_SIZE], y[BATCH_SIZE], angle[BATCH_SIZE], scale_x[BATCH_SIZE], scale_y[BATCH_SIZE];
+    Transform* batch[BATCH_SIZE];
+    Transform2D results[BATCH_SIZE];
+
+    int i = begin;
+    while (i < end)
+    {
+        int batch_count = 0;
+        for (; i < end && batch_count < BATCH_SIZE; i++)
+        {
+            Transform* transform = &world.transforms[i];
+            if (!transform->dirty) continue;
+
+            x[batch_count]       = transform->position.x;
+            y[batch_count]       = transform->position.y;
+            angle[batch_count]   = transform->angle;
+            scale_x[batch_count] = transform->scale.x;
+            scale_y[batch_count] = transform->scale.y;
+            batch[batch_count++] = transform;
+        }
+
+        compose_transforms(x, y, angle, scale_x, scale_y, results, batch_count);
+
+        for (int j = 0; j < batch_count; j++)
+        {
+            batch[j]->matrix = results[j];
+            batch[j]->dirty = false;
+        }
+    }
+}
+
+void update_transforms(World& world, JobSystem* jobs)
+{
+    // transforms per job; fewer than this and handing them out costs more than it saves
+    const int JOB_SIZE = 1024;
+
+    int count = world.transforms.size();
+    if (jobs == nullptr || count <= JOB_SIZE)
+    {
+        update_transform_range(&world, 0, count);
+        return;
+    }
+
+    JobCounter counter;
+    jobs->parallel_for(count, JOB_SIZE, update_transform_range, &world, &counter);
+    jobs->wait(&counter);
+}
+
+void render_sprites(World& world, DrawList* list, SpriteLayer layer, float alpha)
+{
+    for (int i = 0; i < world.sprites.size(); i++)
+    {
+        const Sprite& sprite = world.sprites[i];
+        if (sprite.layer != layer || !sprite.visible) continue;
+
+        EntityId entity = world.sprites.entity_at(i);
+        const Transform& transform = world.transforms.get(entity);
+        const Interpolation* interpolation = world.interpolations.find(entity);
+
+        if (interpolation != nullptr && interpolation->valid && alpha < 1.0f)
+        {
+            // alpha is how far the renderer is into the next, not yet simulated, step
+            list->add_sprite(sprite.texture_id, Transform2D::compose(
+                glm::mix(interpolation->previous_position, transform.position, alpha),
+                glm::mix(interpolation->previous_angle, transform.angle, alpha),
+                transform.scale), sprite.tex_rect);
+        }
+        else
+        {
+            list->add_sprite(sprite.texture_id, transform.matrix, sprite.tex_rect);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "World.h"
+#include "RenderThread.h"
+#include "JobSystem.h"
+
+/**
+* The systems that run over a World. Each walks the dense array of the one
+* component it is about and looks up only the others it needs.
+**/
+
+// Start of every fixed step, before anything moves: remembers where each entity
+// with an Interpolation was, for rendering to blend from.
+void store_previous_transforms(World& world);
+
+// Integrates every Motion (velocity, then position one axis at a time, then angle),
+// pushing Colliders back out of any Solid after each axis.
+void update_motion(World& world, float delta_time);
+
+// Collision system: separates one Collider from every Solid along one axis and zeroes
+// its velocity on that axis. update_motion() calls this between the two axes.
+enum CollisionAxis { AXIS_X, AXIS_Y };
+void resolve_collisions(World& world, EntityId entity, CollisionAxis axis);
+
+// Steps animated sprites and points every animated sprite at its atlas cell.
+void update_animation(World& world, float delta_time);
+
+// Recomposes the matrix of every dirty Transform, in SoA batches; spread over the
+// job system's threads when there are enough transforms to be worth it.
+void update_transforms(World& world, JobSystem* jobs = nullptr);
+
+// Records draws for the visible sprites in one layer, in DrawList's current space.
+void render_sprites(World& world, DrawList* list, SpriteLayer layer, float alpha);
@@ -0,0 +1,246 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include "Telemetry.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
+
+struct TelemetryColumn
+{
+    const char*   name;
+    TelemetryType type;
+};
+
+// the first eight columns are the same in both tables; add_row() counts on it
+static const TelemetryColumn STEP_COLUMNS[] = {
+    { "episode", TELEMETRY_U32 }, { "step", TELEMETRY_U32 },
+    { "x", TELEMETRY_F32 }, { "y", TELEMETRY_F32 }, { "velocity_x", TELEMETRY_F32 }, { "velocity_y", TELEMETRY_F32 },
+    { "angle", TELEMETRY_F32 }, { "fuel", TELEMETRY_F32 },
+    { "too_fast", TELEMETRY_U8 }, { "thrusting", TELEMETRY_U8 },
+};
+static const TelemetryColumn EPISODE_COLUMNS[] = {
+    { "episode", TELEMETRY_U32 }, { "steps", TELEMETRY_U32 },
+    { "x", TELEMETRY_F32 }, { "y", TELEMETRY_F32 }, { "velocity_x", TELEMETRY_F32 }, { "velocity_y", TELEMETRY_F32 },
+    { "angle", TELEMETRY_F32 }, { "fuel", TELEMETRY_F32 },
+    { "outcome", TELEMETRY_U8 },
+};
+
+struct TelemetryTableSpec
+{
+    const char*            name;
+    const TelemetryColumn* columns;
+    uint32_t               column_count;
+};
+
+static const TelemetryTableSpec TABLES[TELEMETRY_TABLE_COUNT] = {
+    { "steps", STEP_COLUMNS, sizeof(STEP_COLUMNS) / sizeof(STEP_COLUMNS[0]) },
+    { "episodes", EPISODE_COLUMNS, sizeof(EPISODE_COLUMNS) / sizeof(EPISODE_COLUMNS[0]) },
+};
+
+static uint32_t get_type_size(TelemetryType type)
+{
+    return type == TELEMETRY_U8 ? 1 : 4;
+}
+
+static uint64_t pad_to_8(uint64_t bytes)
+{
+    return (bytes + 7) & ~(uint64_t)7;
+}
+
+static void write_name(FILE* file, const char* name, size_t size)
+{
+    char padded[32] = {};
+    strncpy(padded, name, size - 1);
+    fwrite(padded, 1, size, file);
+}
+
+bool Telemetry::load(const char* filepath)
+{
+    ALLOCATION_SCOPE(ALLOC_TELEMETRY);
+    m_file = fopen(filepath, "wb");
+    if (m_file == NULL)
+    {
+        std::cout << "Unable to write telemetry: " << filepath << std::endl;
+        return false;
+    }
+
+    // ————— HEADER ————— //
+    const char magic[8] = "KLTELEM";
+    uint32_t header[2] = { VERSION, TELEMETRY_TABLE_COUNT };
+    fwrite(magic, 1, sizeof(magic), m_file);
+    fwrite(header, sizeof(uint32_t), 2, m_file);
+
+    for (int table = 0; table < TELEMETRY_TABLE_COUNT; table++)
+    {
+        const TelemetryTableSpec& spec = TABLES[table];
+        uint32_t counts[2] = { spec.column_count, ROWS_PER_CHUNK };
+        write_name(m_file, spec.name, 16);
+        fwrite(counts, sizeof(uint32_t), 2, m_file);
+
+        m_chunks[table].columns.resize(spec.column_count);
+        for (uint32_t i = 0; i < spec.column_count; i++)
+        {
+            uint32_t type[2] = { spec.columns[i].type, get_type_size(spec.columns[i].type) };
+            write_name(m_file, spec.columns[i].name, 24);
+            fwrite(type, sizeof(uint32_t), 2, m_file);
+            m_chunks[table].columns[i].resize(ROWS_PER_CHUNK * type[1]);
+        }
+    }
+
+    if (ferror(m_file))
+    {
+        std::cout << "Unable to write telemetry: " << filepath << std::endl;
+        fclose(m_file);
+        m_file = NULL;
+        return false;
+    }
+
+    m_records.resize(RING_CAPACITY);
+    m_enabled = true;
+    m_writer = std::thread(&Telemetry::writer_loop, this);
+    return true;
+}
+
+bool Telemetry::cleanup()
+{
+    if (!m_enabled) return true;
+
+    // everything pushed before this is written before the writer stops
+    m_stopping.store(true, std::memory_order_release);
+    m_writer.join();
+    m_enabled = false;
+
+    if (m_stalls > 0) std::cout << "Telemetry writer fell behind; the simulation waited on it " << m_stalls << " times" << std::endl;
+    bool ok = !m_write_failed;
+    if (fclose(m_file) != 0) ok = false;
+    m_file = NULL;
+    if (!ok) std::cout << "Telemetry could not all be written" << std::endl;
+    return ok;
+}
+
+// ————— RECORDING ————— //
+void Telemetry::start_episode()
+{
+    if (!m_enabled) return;
+    m_episode = m_episodes_started++;
+    m_step = 0;
+    m_in_episode = true;
+}
+
+void Telemetry::record_step(const LanderState& lander)
+{
+    if (!m_enabled) return;
+    push({ TELEMETRY_STEPS, 0, m_episode, m_step, lander });
+    if (m_in_episode) m_step++;
+}
+
+void Telemetry::end_episode(EpisodeOutcome outcome, const LanderState& lander)
+{
+    if (!m_enabled or !m_in_episode) return;
+    push({ TELEMETRY_EPISODES, outcome, m_episode, m_step, lander });
+    m_in_episode = false;
+}
+
+// ————— RING ————— //
+void Telemetry::push(const Record& record)
+{
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == RING_CAPACITY)
+    {
+        m_stalls++;
+        while (head - m_tail.load(std::memory_order_acquire) == RING_CAPACITY) std::this_thread::yield();
+    }
+
+    m_records[head % RING_CAPACITY] = record;
+
+    // the record must be written before the writer can see the new head
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+bool Telemetry::pop(Record* record)
+{
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire)) return false;
+
+    *record = m_records[tail % RING_CAPACITY];
+
+    // and read before the simulation can reuse its slot
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+// ————— WRITER SIDE ————— //
+void Telemetry::writer_loop()
+{
+    ALLOCATION_SCOPE(ALLOC_TELEMETRY);
+    Profiler::set_thread_name("telemetry writer");
+    while (true)
+    {
+        // read first: if stopping was already set, an empty ring really is the end
+        bool stopping = m_stopping.load(std::memory_order_acquire);
+
+        Record record;
+        if (pop(&record))
+        {
+            add_row(record);
+            continue;
+        }
+        if (stopping) break;
+
+        // the ring holds far more than a millisecond of steps, even flat out
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (int table = 0; table < TELEMETRY_TABLE_COUNT; table++)
+    {
+        if (m_chunks[table].rows > 0) write_chunk(table);
+    }
+}
+
+void Telemetry::add_row(const Record& record)
+{
+    ChunkBuilder& chunk = m_chunks[record.table];
+    std::vector<std::vector<unsigned char>>& columns = chunk.columns;
+    uint32_t row = chunk.rows;
+
+    const LanderState& lander = record.lander;
+    const float values[] = { lander.position.x, lander.position.y, lander.velocity.x, lander.velocity.y, lander.angle, lander.fuel };
+    memcpy(&columns[0][row * 4], &record.episode, 4);
+    memcpy(&columns[1][row * 4], &record.step, 4);
+    for (int i = 0; i < 6; i++) memcpy(&columns[2 + i][row * 4], &values[i], 4);
+
+    if (record.table == TELEMETRY_STEPS)
+    {
+        columns[8][row] = lander.too_fast ? 1 : 0;
+        columns[9][row] = lander.thrusting ? 1 : 0;
+    }
+    else columns[8][row] = record.outcome;
+
+    if (++chunk.rows == ROWS_PER_CHUNK) write_chunk(record.table);
+}
+
+void Telemetry::write_chunk(int table)
+{
+    PROFILE_ZONE("write telemetry chunk");
+    const TelemetryTableSpec& spec = TABLES[table];
+    ChunkBuilder& chunk = m_chunks[table];
+
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < spec.column_count; i++) bytes += pad_to_8(chunk.rows * get_type_size(spec.columns[i].type));
+
+    uint32_t header[2] = { (uint32_t)table, chunk.rows };
+    fwrite(header, sizeof(uint32_t), 2, m_file);
+    fwrite(&bytes, sizeof(uint64_t), 1, m_file);
+
+    const unsigned char zeros[8] = {};
+    for (uint32_t i = 0; i < spec.column_count; i++)
+    {
+        uint64_t size = chunk.rows * get_type_size(spec.columns[i].type);
+        fwrite(chunk.columns[i].data(), 1, size, m_file);
+        fwrite(zeros, 1, pad_to_8(size) - size, m_file);
+    }
+
+    if (ferror(m_file)) m_write_failed = true;
+    m_rows_written += chunk.rows;
+    chunk.rows = 0;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include "glm/vec2.hpp"
+
+enum TelemetryTable { TELEMETRY_STEPS, TELEMETRY_EPISODES, TELEMETRY_TABLE_COUNT };
+enum TelemetryType : uint32_t { TELEMETRY_U8, TELEMETRY_U32, TELEMETRY_F32 };
+enum EpisodeOutcome : uint8_t { OUTCOME_ABANDONED, OUTCOME_LANDED, OUTCOME_CRASHED };   // abandoned = restarted or quit
+
+// The lander as one step left it.
+struct LanderState
+{
+    glm::vec2 position;
+    glm::vec2 velocity;
+    float     angle;
+    float     fuel;
+    bool      too_fast;
+    bool      thrusting;
+};
+
+/**
+* Writes what the lander did to a binary file: a row for every fixed step, and one
+* for every episode (run) with how it ended, for sweeps of thousands of runs to be
+* analysed without the simulation paying for text.
+*
+* The simulation thread only copies a row into a lock-free single-producer,
+* single-consumer ring; a writer thread takes rows out, transposes them into
+* columns, and writes a chunk whenever a table has ROWS_PER_CHUNK of them. If the
+* writer ever falls a whole ring behind, the simulation waits rather than drop rows.
+*
+* The file is everything in native byte order (little-endian, on anything this
+* runs on), and every part of it starts 8-byte aligned, so it can be mapped and
+* its columns used in place:
+*
+*     header    char magic[8] = "KLTELEM", uint32 version, uint32 table count
+*     per table char name[16], uint32 column count, uint32 rows per chunk
+*               per column: char name[24], uint32 type (TelemetryType), uint32 bytes per value
+*     chunks    uint32 table, uint32 rows, uint64 bytes of columns that follow
+*               each column's values back to back, zero padded to a multiple of 8 bytes
+*
+* Chunks of the two tables are interleaved in the order they filled up; only each
+* table's last chunk can be short.
+**/
+class Telemetry
+{
+public:
+    static const uint32_t VERSION = 1;
+    static const uint32_t ROWS_PER_CHUNK = 4096;
+
+private:
+    static const uint32_t RING_CAPACITY = 16384;   // a power of two, so indices can wrap freely
+
+    struct Record
+    {
+        uint8_t     table;   // TELEMETRY_STEPS or TELEMETRY_EPISODES
+        uint8_t     outcome;
+        uint32_t    episode;
+        uint32_t    step;    // episodes: the steps it took
+        LanderState lander;
+    };
+
+    // one table's rows so far in the chunk being filled, a buffer a column
+    struct ChunkBuilder
+    {
+        std::vector<std::vector<unsigned char>> columns;
+        uint32_t                                rows = 0;
+    };
+
+    // ————— SIMULATION SIDE ————— //
+    bool     m_enabled = false;
+    bool     m_in_episode = false;
+    uint32_t m_episode = 0;
+    uint32_t m_episodes_started = 0;
+    uint32_t m_step = 0;       // within the episode
+    int64_t  m_stalls = 0;     // pushes that found the ring full
+
+    // ————— RING ————— //
+    std::vector<Record> m_records;
+    alignas(64) std::atomic<uint32_t> m_head{ 0 };   // next to write; simulation only
+    alignas(64) std::atomic<uint32_t> m_tail{ 0 };   // next to read; writer only
+    alignas(64) std::atomic<bool>     m_stopping{ false };
+
+    // ————— WRITER SIDE ————— //
+    FILE*        m_file = NULL;
+    ChunkBuilder m_chunks[TELEMETRY_TABLE_COUNT];
+    int64_t      m_rows_written = 0;
+    bool         m_write_failed = false;
+    std::thread  m_writer;
+
+    void push(const Record& record);
+    bool pop(Record* record);
+
+    void writer_loop();
+    void add_row(const Record& record);
+    void write_chunk(int table);
+
+public:
+    bool load(const char* filepath);
+
+    // writes out whatever is still in the ring and closes the file; false if any of it failed
+    bool cleanup();
+
+    bool const is_enabled() const { return m_enabled; };
+    int64_t const get_rows_written() const { return m_rows_written; };   // once cleaned up
+
+    // ————— RECORDING ————— //
+    // the simulation thread's alone
+    void start_episode();
+    bool const in_episode() const { return m_in_episode; };
+
+    void record_step(const LanderState& lander);
+
+    // the steps that follow, until the next start_episode(), are still recorded
+    // under this episode, but not counted in its steps
+    void end_episode(EpisodeOutcome outcome, const LanderState& lander);
+};
@@ -0,0 +1,432 @@
+#define GL_SILENCE_DEPRECATION
+
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include "TerrainStreamer.h"
+#include "Transform2D.h"
+#include "Profiler.h"
+#include "GLStats.h"
+#include "AllocationTracker.h"
+
+// ————— IMAGE SOURCE ————— //
+
+void ImageTerrainSource::load(const char* path_pattern, const char* fallback_path,
+                              const glm::vec3* local_pads, int pad_count)
+{
+    m_path_pattern = path_pattern;
+    m_fallback_path = fallback_path;
+    m_local_pads.assign(local_pads, local_pads + pad_count);
+}
+
+bool ImageTerrainSource::load_chunk(int index, float min_x, float chunk_width, float chunk_height, TerrainChunk& chunk)
+{
+    char path[512];
+    snprintf(path, sizeof(path), m_path_pattern.c_str(), index);
+
+    int width, height;
+    unsigned char* image = load_image_pixels(path, &width, &height);
+    if (image == NULL) image = load_image_pixels(m_fallback_path.c_str(), &width, &height);
+    if (image == NULL) return false;
+
+    chunk.pixels.assign(image, image + width * height * 4);
+    chunk.pixel_width = width;
+    chunk.pixel_height = height;
+    free_image_pixels(image);
+
+    // trace the surface: the first mostly-opaque pixel from the top of each column
+    float top_y = chunk_height / 2.0f;
+    float units_per_pixel = chunk_height / height;
+    chunk.heights.resize(width);
+
+    for (int x = 0; x < width; x++)
+    {
+        int surface_row = height;
+        for (int y = 0; y < height; y++)
+        {
+            if (chunk.pixels[(y * width + x) * 4 + 3] > 128)
+            {
+                surface_row = y;
+                break;
+            }
+        }
+        chunk.heights[x] = top_y - (surface_row + 0.5f) * units_per_pixel;
+    }
+
+    float centre_x = min_x + chunk_width / 2.0f;
+    for (const glm::vec3& pad : m_local_pads)
+    {
+        chunk.pads.push_back(glm::vec3(centre_x + pad.x, pad.y, pad.z));
+    }
+
+    return true;
+}
+
+// ————— STREAMER ————— //
+
+void TerrainStreamer::load(TerrainSource* source, int chunk_count, float min_x,
+                           float chunk_width, float chunk_height, int radius)
+{
+    ALLOCATION_SCOPE(ALLOC_TERRAIN);
+    m_source = source;
+    m_chunk_count = chunk_count;
+    m_min_x = min_x;
+    m_chunk_width = chunk_width;
+    m_chunk_height = chunk_height;
+    m_radius = radius;
+    m_centre = 0;
+
+    // at most the centre chunk, the radius either side and one chunk of slack each way
+    m_free_textures.resize(2 * radius + 3);
+    glGenTextures((GLsizei)m_free_textures.size(), m_free_textures.data());
+
+    m_stopping = false;
+    m_worker = std::thread(&TerrainStreamer::worker_loop, this);
+}
+
+int TerrainStreamer::get_chunk_index(float x) const
+{
+    int index = (int)floorf((x - m_min_x) / m_chunk_width);
+    return index < 0 ? 0 : index >= m_chunk_count ? m_chunk_count - 1 : index;
+}
+
+void TerrainStreamer::worker_loop()
+{
+    Profiler::set_thread_name("terrain streaming");
+    while (true)
+    {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work_ready.wait(lock, [this] { return m_stopping || !m_requests.empty(); });
+            if (m_stopping) return;
+
+            index = m_requests.front();
+            m_requests.pop_front();
+        }
+
+        TerrainChunk* chunk = produce(index);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished.push_back(chunk);
+    }
+}
+
+TerrainChunk* TerrainStreamer::produce(int index)
+{
+    ALLOCATION_SCOPE(ALLOC_TERRAIN);
+    PROFILE_ZONE("produce terrain chunk");
+    TerrainChunk* chunk = new TerrainChunk();
+    chunk->index = index;
+    if (!m_source->load_chunk(index, m_min_x + index * m_chunk_width, m_chunk_width, m_chunk_height, *chunk))
+    {
+        std::cout << "Unable to load terrain chunk " << index << std::endl;
+    }
+
+    build_collision(*chunk);
+
+    // the format conversion is the expensive half of a texture upload, so it happens here
+    if (!chunk->pixels.empty())
+    {
+        encode_texture(chunk->pixels.data(), chunk->pixel_width, chunk->pixel_height, TEXTURE_AUTO, chunk->texture_data);
+    }
+    std::vector<unsigned char>().swap(chunk->pixels);
+
+    return chunk;
+}
+
+void TerrainStreamer::build_collision(TerrainChunk& chunk) const
+{
+    // the surface runs flat from each edge of the chunk to the first and last samples,
+    // as get_resident_ground_level() has it, and the walls close it off against the
+    // neighbours, which can stand at a different height
+    float min_x = m_min_x + chunk.index * m_chunk_width;
+    float max_x = min_x + m_chunk_width;
+    float bottom = -m_chunk_height / 2.0f;
+
+    std::vector<glm::vec2> ends;
+    if (chunk.heights.empty())
+    {
+        ends = { glm::vec2(min_x, bottom), glm::vec2(max_x, bottom) };
+        chunk.collision.build(ends);
+        return;
+    }
+
+    int sample_count = (int)chunk.heights.size();
+    float sample_width = m_chunk_width / sample_count;
+    ends.reserve(2 * (sample_count + 3));
+
+    glm::vec2 previous(min_x, bottom);
+    glm::vec2 point(min_x, chunk.heights.front());
+    ends.push_back(previous);
+    ends.push_back(point);
+    for (int i = 0; i < sample_count; i++)
+    {
+        previous = point;
+        point = glm::vec2(min_x + (i + 0.5f) * sample_width, chunk.heights[i]);
+        ends.push_back(previous);
+        ends.push_back(point);
+    }
+    ends.push_back(point);
+    ends.push_back(glm::vec2(max_x, point.y));
+    ends.push_back(glm::vec2(max_x, point.y));
+    ends.push_back(glm::vec2(max_x, bottom));
+
+    chunk.collision.build(ends);
+}
+
+void TerrainStreamer::adopt(TerrainChunk* chunk)
+{
+    // the streaming thread might have raced a synchronous load of the same chunk
+    if (m_resident.count(chunk->index) != 0)
+    {
+        delete chunk;
+        return;
+    }
+
+    if (!chunk->texture_data.texels.empty())
+    {
+        if (m_free_textures.empty())
+        {
+            std::cout << "No texture free for terrain chunk " << chunk->index << std::endl;
+        }
+        else
+        {
+            chunk->texture_id = m_free_textures.back();
+            m_free_textures.pop_back();
+            m_pending_uploads.push_back({ chunk->texture_id, std::move(chunk->texture_data) });
+        }
+    }
+    chunk->texture_data = TextureData();
+
+    m_resident[chunk->index] = chunk;
+}
+
+void TerrainStreamer::evict(TerrainChunk* chunk)
+{
+    if (chunk->texture_id != 0) m_free_textures.push_back(chunk->texture_id);
+    delete chunk;
+}
+
+const TerrainChunk* TerrainStreamer::load_now(int index, std::vector<TerrainChunk*>& transient)
+{
+    // used when the simulation needs a chunk that hasn't streamed in yet
+    auto it = m_resident.find(index);
+    if (it != m_resident.end()) return it->second;
+
+    ALLOCATION_SCOPE(ALLOC_TERRAIN);
+    TerrainChunk* chunk = produce(index);
+
+    // only chunks in range of the camera are sure of a texture name; anything further
+    // out (the lander can get ahead of the camera) is used once and not kept
+    if (abs(index - m_centre) > m_radius + 1 or m_free_textures.empty())
+    {
+        transient.push_back(chunk);
+        return chunk;
+    }
+    adopt(chunk);
+    return chunk;
+}
+
+bool TerrainStreamer::update(float camera_x)
+{
+    ALLOCATION_SCOPE(ALLOC_TERRAIN);
+    bool changed = false;
+    int centre = get_chunk_index(camera_x);
+    m_centre = centre;
+
+    // STEP 1: Evict first, so there's a texture free for everything adopted below;
+    //         one chunk of slack stops a camera sitting on a border from thrashing
+    for (auto it = m_resident.begin(); it != m_resident.end();)
+    {
+        if (abs(it->first - centre) > m_radius + 1)
+        {
+            evict(it->second);
+            it = m_resident.erase(it);
+            changed = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // STEP 2: Take whatever the streaming thread has finished
+    std::vector<TerrainChunk*> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        finished.swap(m_finished);
+        for (TerrainChunk* chunk : finished) m_in_flight.erase(chunk->index);
+    }
+    for (TerrainChunk* chunk : finished)
+    {
+        // it may have scrolled out of range while it was loading
+        if (abs(chunk->index - centre) > m_radius + 1)
+        {
+            delete chunk;
+            continue;
+        }
+        adopt(chunk);
+        changed = true;
+    }
+
+    // STEP 3: The chunk under the camera can't wait
+    if (m_resident.count(centre) == 0)
+    {
+        // (with no texture free it comes back transient, and is tried again next frame)
+        std::vector<TerrainChunk*> transient;
+        load_now(centre, transient);
+        for (TerrainChunk* chunk : transient) delete chunk;
+        changed = true;
+    }
+
+    // STEP 4: Ask for the neighbours, nearest first
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int distance = 1; distance <= m_radius; distance++)
+        {
+            for (int index : { centre - distance, centre + distance })
+            {
+                if (index < 0 || index >= m_chunk_count) continue;
+                if (m_resident.count(index) != 0 || m_in_flight.count(index) != 0) continue;
+
+                m_requests.push_back(index);
+                m_in_flight.insert(index);
+            }
+        }
+    }
+    m_work_ready.notify_one();
+
+    return changed;
+}
+
+float TerrainStreamer::get_ground_level(float x)
+{
+    std::vector<TerrainChunk*> transient;
+    float level = get_chunk_ground_level(*load_now(get_chunk_index(x), transient), x);
+
+    for (TerrainChunk* chunk : transient) delete chunk;
+    return level;
+}
+
+float TerrainStreamer::get_resident_ground_level(float x) const
+{
+    return get_chunk_ground_level(*m_resident.at(get_chunk_index(x)), x);
+}
+
+float TerrainStreamer::get_chunk_ground_level(const TerrainChunk& chunk, float x) const
+{
+    if (chunk.heights.empty()) return -m_chunk_height / 2.0f;
+
+    // linear interpolation between the two nearest samples
+    int sample_count = (int)chunk.heights.size();
+    float sample = (x - (m_min_x + chunk.index * m_chunk_width)) / m_chunk_width * sample_count - 0.5f;
+    if (sample <= 0.0f) return chunk.heights.front();
+    if (sample >= sample_count - 1) return chunk.heights.back();
+
+    int left = (int)sample;
+    float t = sample - left;
+    return chunk.heights[left] * (1.0f - t) + chunk.heights[left + 1] * t;
+}
+
+bool TerrainStreamer::hull_hits_ground(const PlacedHull& hull)
+{
+    if (hull.count == 0) return false;
+    std::vector<TerrainChunk*> transient;
+    bool hit = false;
+    for (int index = get_chunk_index(hull.min.x); index <= get_chunk_index(hull.max.x) and !hit; index++)
+    {
+        hit = load_now(index, transient)->collision.touches(hull);
+    }
+
+    // crossing no part of the outline, it is either all above ground or all below
+    if (!hit)
+    {
+        const TerrainChunk* chunk = load_now(get_chunk_index(hull.points[0].x), transient);
+        hit = hull.points[0].y <= get_chunk_ground_level(*chunk, hull.points[0].x);
+    }
+
+    for (TerrainChunk* chunk : transient) delete chunk;
+    return hit;
+}
+
+bool TerrainStreamer::resident_hull_hits_ground(const PlacedHull& hull) const
+{
+    if (hull.count == 0) return false;
+    for (int index = get_chunk_index(hull.min.x); index <= get_chunk_index(hull.max.x); index++)
+    {
+        if (m_resident.at(index)->collision.touches(hull)) return true;
+    }
+
+    // crossing no part of the outline, it is either all above ground or all below
+    return hull.points[0].y <= get_resident_ground_level(hull.points[0].x);
+}
+
+int TerrainStreamer::collect_pads(glm::vec3* pads, int max_pads) const
+{
+    int count = 0;
+    for (const auto& entry : m_resident)
+    {
+        for (const glm::vec3& pad : entry.second->pads)
+        {
+            if (count == max_pads) return count;
+            pads[count++] = pad;
+        }
+    }
+    return count;
+}
+
+void TerrainStreamer::get_resident_range(float* min_x, float* max_x) const
+{
+    if (m_resident.empty())
+    {
+        *min_x = *max_x = m_min_x;
+        return;
+    }
+
+    *min_x = m_min_x + m_resident.begin()->first * m_chunk_width;
+    *max_x = m_min_x + (m_resident.rbegin()->first + 1) * m_chunk_width;
+}
+
+void TerrainStreamer::render(DrawList* list)
+{
+    // the GL thread runs these before drawing anything from the same list
+    for (TextureUpload& upload : m_pending_uploads) list->uploads.push_back(std::move(upload));
+    m_pending_uploads.clear();
+
+    for (const auto& entry : m_resident)
+    {
+        if (entry.second->texture_id == 0) continue;
+
+        float centre_x = m_min_x + (entry.first + 0.5f) * m_chunk_width;
+        list->add_sprite(entry.second->texture_id, Transform2D::compose(
+            glm::vec2(centre_x, 0.0f), 0.0f, glm::vec2(m_chunk_width, m_chunk_height)));
+    }
+}
+
+void TerrainStreamer::cleanup()
+{
+    if (m_worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_work_ready.notify_one();
+        m_worker.join();
+    }
+
+    for (TerrainChunk* chunk : m_finished) delete chunk;
+    m_finished.clear();
+    m_requests.clear();
+    m_in_flight.clear();
+
+    for (auto& entry : m_resident) evict(entry.second);
+    m_resident.clear();
+    m_pending_uploads.clear();
+
+    glDeleteTextures((GLsizei)m_free_textures.size(), m_free_textures.data());
+    GLStats::forget_textures(m_free_textures.data(), (int)m_free_textures.size());
+    m_free_textures.clear();
+}
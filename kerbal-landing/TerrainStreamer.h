@@ -0,0 +1,154 @@
+#pragma once
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "glm/vec3.hpp"
+#include "RenderThread.h"
+#include "Collision.h"
+
+/**
+* One screen-sized slice of the world. The CPU-side data is produced by a
+* TerrainSource on the streaming thread; the texture is created later on the GL thread.
+**/
+struct TerrainChunk
+{
+    int index = 0;
+
+    // surface height in world units, evenly sampled across the chunk's width
+    std::vector<float> heights;
+
+    // landing pad centres in world coordinates
+    std::vector<glm::vec3> pads;
+
+    // the outline of the ground under the surface, for hulls to collide with: the
+    // surface as get_resident_ground_level() sees it, with walls down each edge
+    SegmentBVH collision;
+
+    // decoded RGBA8, top row first, as the source produced it; the streaming thread
+    // then encodes it into texture_data and releases it
+    std::vector<unsigned char> pixels;
+    int pixel_width = 0,
+        pixel_height = 0;
+    TextureData texture_data;
+
+    GLuint texture_id = 0;
+};
+
+/**
+* Where chunk data comes from. load_chunk() is called on the streaming thread and
+* may be called concurrently with itself, so implementations must not share
+* mutable state between calls.
+**/
+class TerrainSource
+{
+public:
+    virtual ~TerrainSource() {};
+    virtual bool load_chunk(int index, float min_x, float chunk_width, float chunk_height, TerrainChunk& chunk) = 0;
+};
+
+/**
+* Chunks read from image files, one per screen: the path pattern is printf'd with
+* the chunk index and falls back to a default image for indices that have no file.
+* The collision profile is traced from the image's alpha channel (first opaque
+* pixel from the top in every column), so it always matches the art. Pads are
+* placed at the same chunk-local coordinates in every chunk.
+**/
+class ImageTerrainSource : public TerrainSource
+{
+private:
+    std::string            m_path_pattern;
+    std::string            m_fallback_path;
+    std::vector<glm::vec3> m_local_pads;
+
+public:
+    void load(const char* path_pattern, const char* fallback_path,
+              const glm::vec3* local_pads, int pad_count);
+
+    bool load_chunk(int index, float min_x, float chunk_width, float chunk_height, TerrainChunk& chunk) override;
+};
+
+/**
+* Keeps the chunks around the camera resident and nothing else.
+*
+* update() runs on the simulation thread once per frame: it evicts chunks that have
+* fallen out of range, adopts chunks the streaming thread has finished, and queues
+* loads for chunks that have come within range, so memory stays bounded by the
+* streaming radius whatever the size of the world.
+*
+* The simulation thread can't make GL calls, so load() creates one texture name
+* for every chunk that can ever be resident at once; adopting a chunk hands it a
+* free name and queues its texels, which render() passes to the GL thread in the
+* next DrawList. Evicted chunks give their name back for reuse.
+**/
+class TerrainStreamer
+{
+private:
+    TerrainSource* m_source = nullptr;
+    int   m_chunk_count = 0;
+    float m_min_x = 0.0f;
+    float m_chunk_width = 0.0f;
+    float m_chunk_height = 0.0f;  // chunks are centred vertically on y = 0
+    int   m_radius = 1;
+    int   m_centre = 0;       // the chunk under the camera at the last update()
+
+    // ————— SIMULATION THREAD ————— //
+    std::map<int, TerrainChunk*> m_resident;
+    std::vector<GLuint>          m_free_textures;
+    std::vector<TextureUpload>   m_pending_uploads;
+
+    // ————— STREAMING THREAD ————— //
+    std::thread                 m_worker;
+    std::mutex                  m_mutex;
+    std::condition_variable     m_work_ready;
+    std::deque<int>             m_requests;
+    std::set<int>               m_in_flight;
+    std::vector<TerrainChunk*>  m_finished;
+    bool                        m_stopping = false;
+
+    int  get_chunk_index(float x) const;
+    void worker_loop();
+    TerrainChunk* produce(int index);
+    void build_collision(TerrainChunk& chunk) const;
+    void adopt(TerrainChunk* chunk);
+    void evict(TerrainChunk* chunk);
+    const TerrainChunk* load_now(int index, std::vector<TerrainChunk*>& transient);
+    float get_chunk_ground_level(const TerrainChunk& chunk, float x) const;
+
+public:
+    // load() and cleanup() make GL calls
+    void load(TerrainSource* source, int chunk_count, float min_x,
+              float chunk_width, float chunk_height, int radius);
+    bool update(float camera_x);
+    void render(DrawList* list);
+    void cleanup();
+
+    // loads the chunk under x if it isn't resident; one out of streaming range is
+    // loaded just for the query and not kept, having no texture name to take
+    float get_ground_level(float x);
+    // the same, but only for resident chunks (x inside get_resident_range()); read-only,
+    // so any number of threads may call it at once between calls to update()
+    float get_resident_ground_level(float x) const;
+
+    // whether the hull overlaps the ground, loading the chunks under it if need be,
+    // and the same for resident chunks only, like the ground levels
+    bool  hull_hits_ground(const PlacedHull& hull);
+    bool  resident_hull_hits_ground(const PlacedHull& hull) const;
+
+    int   collect_pads(glm::vec3* pads, int max_pads) const;
+    void  get_resident_range(float* min_x, float* max_x) const;
+
+    float const get_min_x() const { return m_min_x; };
+    float const get_max_x() const { return m_min_x + m_chunk_count * m_chunk_width; };
+    int   const get_resident_count() const { return (int)m_resident.size(); };
+};
@@ -0,0 +1,203 @@
+#define GL_SILENCE_DEPRECATION
+#define STB_IMAGE_IMPLEMENTATION
+
+#include <algorithm>
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include "AllocationTracker.h"
+
+// decoded images are counted like everything else when allocations are tracked
+#ifdef KERBAL_TRACK_ALLOCATIONS
+#define STBI_MALLOC(size) AllocationTracker::allocate(size)
+#define STBI_REALLOC(memory, size) AllocationTracker::reallocate(memory, size)
+#define STBI_FREE(memory) AllocationTracker::release(memory)
+#endif
+
+#include "stb_image.h"
+#include "Texture.h"
+#include "Profiler.h"
+#include "GLStats.h"
+
+const int NUMBER_OF_TEXTURES = 1;  // to be generated, that is
+const GLint LEVEL_OF_DETAIL = 0;  // base image level; Level n is the nth mipmap reduction image
+const GLint TEXTURE_BORDER = 0;  // this value MUST be zero
+
+// an alpha mask's colour channels must all be at least this bright wherever it's visible
+const unsigned char MASK_MIN_BRIGHTNESS = 250;
+
+unsigned char* load_image_pixels(const char* filepath, int* width, int* height)
+{
+    ALLOCATION_SCOPE(ALLOC_TEXTURES);
+    int number_of_components;
+    return stbi_load(filepath, width, height, &number_of_components, STBI_rgb_alpha);
+}
+
+void free_image_pixels(unsigned char* pixels)
+{
+    stbi_image_free(pixels);
+}
+
+TextureFormat choose_texture_format(const unsigned char* pixels, int width, int height)
+{
+    bool opaque = true;
+    bool white = true;
+
+    for (int i = 0; i < width * height; i++)
+    {
+        const unsigned char* pixel = &pixels[i * 4];
+        if (pixel[3] != 255) opaque = false;
+        if (pixel[3] != 0 and (pixel[0] < MASK_MIN_BRIGHTNESS or pixel[1] < MASK_MIN_BRIGHTNESS or pixel[2] < MASK_MIN_BRIGHTNESS)) white = false;
+        if (!opaque and !white) return TEXTURE_RGBA4;
+    }
+
+    if (opaque) return TEXTURE_RGB565;
+    return TEXTURE_ALPHA8;
+}
+
+static inline unsigned int reduce(unsigned char channel, unsigned int bits)
+{
+    // round to nearest rather than truncating, so mid-greys stay mid-grey
+    unsigned int max = (1u << bits) - 1;
+    return (channel * max + 127) / 255;
+}
+
+void encode_texture(const unsigned char* pixels, int width, int height, TextureFormat format, TextureData& data)
+{
+    ALLOCATION_SCOPE(ALLOC_TEXTURES);
+    if (format == TEXTURE_AUTO) format = choose_texture_format(pixels, width, height);
+
+    int pixel_count = width * height;
+    data.format = format;
+    data.width = width;
+    data.height = height;
+
+    switch (format)
+    {
+    case TEXTURE_RGBA4:
+    {
+        data.texels.resize(pixel_count * 2);
+        uint16_t* texels = (uint16_t*)data.texels.data();
+        for (int i = 0; i < pixel_count; i++)
+        {
+            const unsigned char* pixel = &pixels[i * 4];
+            texels[i] = (uint16_t)(reduce(pixel[0], 4) << 12 | reduce(pixel[1], 4) << 8 | reduce(pixel[2], 4) << 4 | reduce(pixel[3], 4));
+        }
+        break;
+    }
+    case TEXTURE_RGB565:
+    {
+        data.texels.resize(pixel_count * 2);
+        uint16_t* texels = (uint16_t*)data.texels.data();
+        for (int i = 0; i < pixel_count; i++)
+        {
+            const unsigned char* pixel = &pixels[i * 4];
+            texels[i] = (uint16_t)(reduce(pixel[0], 5) << 11 | reduce(pixel[1], 6) << 5 | reduce(pixel[2], 5));
+        }
+        break;
+    }
+    case TEXTURE_ALPHA8:
+    {
+        data.texels.resize(pixel_count);
+        for (int i = 0; i < pixel_count; i++) data.texels[i] = pixels[i * 4 + 3];
+        break;
+    }
+    default:
+        data.format = TEXTURE_RGBA8;
+        data.texels.assign(pixels, pixels + pixel_count * 4);
+        break;
+    }
+}
+
+GLuint upload_texture(const TextureData& data)
+{
+    GLuint textureID;
+    glGenTextures(NUMBER_OF_TEXTURES, &textureID);
+    upload_texture(textureID, data);
+
+    return textureID;
+}
+
+void upload_texture(GLuint texture_id, const TextureData& data)
+{
+    gl_bind_texture(GL_TEXTURE_2D, texture_id);
+
+    // the shaders see white, with the single channel as alpha; a reused name may
+    // have been an alpha mask before, so every other format resets this
+    bool mask = data.format == TEXTURE_ALPHA8;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, mask ? GL_ONE : GL_RED);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, mask ? GL_ONE : GL_GREEN);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, mask ? GL_ONE : GL_BLUE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, mask ? GL_RED : GL_ALPHA);
+
+    // 8- and 16-bit rows aren't necessarily a multiple of 4 bytes long
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    switch (data.format)
+    {
+    case TEXTURE_RGBA4:
+        glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA4, data.width, data.height, TEXTURE_BORDER,
+                     GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, data.texels.data());
+        break;
+    case TEXTURE_RGB565:
+        glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGB565, data.width, data.height, TEXTURE_BORDER,
+                     GL_RGB, GL_UNSIGNED_SHORT_5_6_5, data.texels.data());
+        break;
+    case TEXTURE_ALPHA8:
+        glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_R8, data.width, data.height, TEXTURE_BORDER,
+                     GL_RED, GL_UNSIGNED_BYTE, data.texels.data());
+        break;
+    default:
+        glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA8, data.width, data.height, TEXTURE_BORDER,
+                     GL_RGBA, GL_UNSIGNED_BYTE, data.texels.data());
+        break;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // trilinear when sprites are drawn smaller than their images
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    // the base level and every mipmap under it
+    int64_t bytes = 0;
+    if (data.width > 0 and data.height > 0)
+    {
+        int64_t bytes_per_texel = (int64_t)data.texels.size() / ((int64_t)data.width * data.height);
+        for (int width = data.width, height = data.height; ; width = std::max(width / 2, 1), height = std::max(height / 2, 1))
+        {
+            bytes += (int64_t)width * height * bytes_per_texel;
+            if (width == 1 and height == 1) break;
+        }
+    }
+    GLStats::set_texture_size(texture_id, bytes);
+}
+
+GLuint create_texture(const unsigned char* pixels, int width, int height, TextureFormat format)
+{
+    TextureData data;
+    encode_texture(pixels, width, height, format, data);
+    return upload_texture(data);
+}
+
+GLuint load_texture(const char* filepath, TextureFormat format)
+{
+    PROFILE_ZONE("load_texture");
+    int width, height;
+    unsigned char* image = load_image_pixels(filepath, &width, &height);
+
+    if (image == NULL)
+    {
+        std::cout << "Unable to load image. Make sure the path is correct: " << filepath << std::endl;
+        assert(false);
+    }
+
+    GLuint textureID = create_texture(image, width, height, format);
+    free_image_pixels(image);
+
+    return textureID;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+
+// How texels are stored on the GPU. Every format samples as RGBA in the shaders.
+enum TextureFormat
+{
+    TEXTURE_AUTO,     // pick the smallest of the below that suits the image
+    TEXTURE_RGBA8,    // 32 bits; kept for anything that needs it explicitly
+    TEXTURE_RGBA4,    // 16 bits; translucent sprites
+    TEXTURE_RGB565,   // 16 bits; fully opaque images
+    TEXTURE_ALPHA8,   //  8 bits; white-on-transparent masks and fonts, swizzled to (1, 1, 1, a)
+};
+
+// Texels converted to their GPU format, ready to upload.
+struct TextureData
+{
+    TextureFormat              format = TEXTURE_RGBA8;
+    int                        width = 0,
+                               height = 0;
+    std::vector<unsigned char> texels;
+};
+
+// Decodes an image file and uploads it; asserts if the file can't be read.
+GLuint load_texture(const char* filepath, TextureFormat format = TEXTURE_AUTO);
+
+// Uploads already-decoded, top-row-first RGBA8 pixels. Must run on the GL thread;
+// the decoding that produced the pixels can happen anywhere.
+GLuint create_texture(const unsigned char* pixels, int width, int height, TextureFormat format = TEXTURE_AUTO);
+
+// The two halves of create_texture(): encode_texture() does the conversion and is
+// safe on any thread, upload_texture() builds the mip chain and must run on the GL thread.
+// The second form replaces the contents (and format) of an existing texture name.
+void   encode_texture(const unsigned char* pixels, int width, int height, TextureFormat format, TextureData& data);
+GLuint upload_texture(const TextureData& data);
+void   upload_texture(GLuint texture_id, const TextureData& data);
+
+// Which format TEXTURE_AUTO would choose for these pixels.
+TextureFormat choose_texture_format(const unsigned char* pixels, int width, int height);
+
+// Decodes an image file into RGBA8 without touching GL, so it is safe off the GL
+// thread. Free the result with free_image_pixels(); returns NULL on failure.
+unsigned char* load_image_pixels(const char* filepath, int* width, int* height);
+void free_image_pixels(unsigned char* pixels);
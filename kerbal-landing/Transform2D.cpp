@@ -0,0 +1,37 @@
+#include <cmath>
+#include "Transform2D.h"
+
+static const float DEGREES_TO_RADIANS = 3.14159265358979f / 180.0f;
+
+Transform2D Transform2D::compose(glm::vec2 position, float angle_degrees, glm::vec2 scale)
+{
+    float sine   = sinf(angle_degrees * DEGREES_TO_RADIANS);
+    float cosine = cosf(angle_degrees * DEGREES_TO_RADIANS);
+
+    Transform2D transform;
+    transform.a  = cosine * scale.x;
+    transform.b  = sine   * scale.x;
+    transform.c  = -sine  * scale.y;
+    transform.d  = cosine * scale.y;
+    transform.tx = position.x;
+    transform.ty = position.y;
+    return transform;
+}
+
+void compose_transforms(const float* x, const float* y, const float* angle_degrees,
+                        const float* scale_x, const float* scale_y,
+                        Transform2D* out, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        float sine   = sinf(angle_degrees[i] * DEGREES_TO_RADIANS);
+        float cosine = cosf(angle_degrees[i] * DEGREES_TO_RADIANS);
+
+        out[i].a  = cosine * scale_x[i];
+        out[i].b  = sine   * scale_x[i];
+        out[i].c  = -sine  * scale_y[i];
+        out[i].d  = cosine * scale_y[i];
+        out[i].tx = x[i];
+        out[i].ty = y[i];
+    }
+}
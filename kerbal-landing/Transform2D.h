@@ -0,0 +1,30 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+
+/**
+* A 2D affine transform, stored as the top two rows of a 3x3 matrix:
+*
+*     | a  c  tx |
+*     | b  d  ty |
+*
+* That is all a sprite in this game ever needs (translate, rotate about Z, scale),
+* in 6 floats instead of the 16 of a glm::mat4. The fields are laid out row by row
+* so the struct can be uploaded as-is to a `uniform vec3 modelTransform[2]`.
+**/
+struct Transform2D
+{
+    float a = 1.0f, c = 0.0f, tx = 0.0f;
+    float b = 0.0f, d = 1.0f, ty = 0.0f;
+
+    // equivalent to translate(position) * rotate(angle) * scale(scale)
+    static Transform2D compose(glm::vec2 position, float angle_degrees, glm::vec2 scale);
+
+    glm::vec2 apply(glm::vec2 point) const { return glm::vec2(a * point.x + c * point.y + tx, b * point.x + d * point.y + ty); };
+};
+
+// Batch form of Transform2D::compose over structure-of-arrays input. The loop body
+// is branch-free so the compiler can vectorise everything but the sin/cos.
+void compose_transforms(const float* x, const float* y, const float* angle_degrees,
+                        const float* scale_x, const float* scale_y,
+                        Transform2D* out, int count);
@@ -0,0 +1,56 @@
+#include "World.h"
+
+void World::load(Arena& arena, int max_entities)
+{
+    transforms.load(arena, max_entities);
+    interpolations.load(arena, max_entities);
+    motions.load(arena, max_entities);
+    colliders.load(arena, max_entities);
+    solids.load(arena, max_entities);
+    sprites.load(arena, max_entities);
+    animations.load(arena, max_entities);
+
+    m_free_ids = arena.allocate_array<EntityId>(max_entities);
+    assert(m_free_ids != nullptr);
+    m_capacity = max_entities;
+    m_free_count = 0;
+    m_next_id = 0;
+}
+
+EntityId World::create()
+{
+    if (m_free_count == 0)
+    {
+        assert((int)m_next_id < m_capacity);
+        return m_next_id++;
+    }
+
+    return m_free_ids[--m_free_count];
+}
+
+void World::destroy(EntityId entity)
+{
+    transforms.remove(entity);
+    interpolations.remove(entity);
+    motions.remove(entity);
+    colliders.remove(entity);
+    solids.remove(entity);
+    sprites.remove(entity);
+    animations.remove(entity);
+
+    m_free_ids[m_free_count++] = entity;
+}
+
+void World::clear()
+{
+    transforms.clear();
+    interpolations.clear();
+    motions.clear();
+    colliders.clear();
+    solids.clear();
+    sprites.clear();
+    animations.clear();
+
+    m_free_count = 0;
+    m_next_id = 0;
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <new>
+#include <type_traits>
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+#include "Transform2D.h"
+#include "Arena.h"
+
+typedef uint32_t EntityId;
+
+// ————— COMPONENTS ————— //
+
+struct Transform
+{
+    glm::vec2 position = glm::vec2(0.0f);
+    float     angle = 0.0f;                 // degrees, anticlockwise
+    glm::vec2 scale = glm::vec2(1.0f);
+
+    // recomposed by update_transforms(), only after one of the above has changed
+    Transform2D matrix;
+    bool        dirty = true;
+
+    void set_position(glm::vec2 new_position) { position = new_position; dirty = true; };
+    void set_angle(float new_angle) { angle = new_angle; dirty = true; };
+    void set_scale(glm::vec2 new_scale) { scale = new_scale; dirty = true; };
+};
+
+// Where a moving entity was at the start of the current fixed step, so rendering can
+// blend towards where the step left it.
+struct Interpolation
+{
+    glm::vec2 previous_position = glm::vec2(0.0f);
+    float     previous_angle = 0.0f;
+    bool      valid = false;
+};
+
+struct Motion
+{
+    glm::vec2 velocity = glm::vec2(0.0f);
+    glm::vec2 acceleration = glm::vec2(0.0f);
+    float     rotation = 0.0f;              // -1 clockwise, 1 anticlockwise, 0 still
+    float     rotation_speed = 1.0f;        // in units of 45 degrees per second
+};
+
+// A moving box that stops against Solids; the flags say which sides touched last step.
+struct Collider
+{
+    bool collided_top = false;
+    bool collided_bottom = false;
+    bool collided_left = false;
+    bool collided_right = false;
+};
+
+// A static box (the size of its Transform's scale) that Colliders can't pass through.
+struct Solid
+{
+};
+
+enum SpriteLayer { LAYER_BACKGROUND, LAYER_FLAME, LAYER_PLAYER, LAYER_PADS, LAYER_HUD, LAYER_OVERLAY };
+
+struct Sprite
+{
+    GLuint      texture_id = 0;
+    glm::vec4   tex_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);   // u, v, width, height
+    SpriteLayer layer = LAYER_BACKGROUND;
+    bool        visible = true;
+};
+
+// Picks a Sprite's cell out of a grid-shaped atlas, optionally stepping through frames.
+struct Animation
+{
+    int   columns = 1,
+          rows = 1;
+    int   frame = 0;              // cell index, row by row from the top left
+    int   first_frame = 0;
+    int   frame_count = 1;        // 1 = a still image
+    float seconds_per_frame = 0.25f;
+    float frame_time = 0.0f;
+};
+
+/**
+* Sparse-set storage for one component type. The components themselves are packed
+* densely, in no particular order, so a system walking a pool touches only the
+* memory it needs; the sparse array maps an entity to its slot in O(1). Removal
+* swaps the last component into the hole, so the pool never has gaps.
+*
+* All three arrays are fixed-size and carved out of an Arena by load(), so adding
+* a component never allocates. The sparse array is zeroed once by load() and never
+* tidied after: an entity only has a component if its slot is in use and points
+* back at it, which is what lets clear() forget every component in O(1).
+**/
+template <typename T>
+class ComponentPool
+{
+private:
+    uint32_t* m_sparse = nullptr;      // indexed by entity
+    EntityId* m_entities = nullptr;    // dense, parallel to m_components
+    T*        m_components = nullptr;
+    uint32_t  m_capacity = 0;          // max entity id + 1, and max components
+    uint32_t  m_size = 0;
+
+public:
+    void load(Arena& arena, int capacity)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "components are never destroyed");
+
+        m_sparse = arena.allocate_array<uint32_t>(capacity);
+        m_entities = arena.allocate_array<EntityId>(capacity);
+        m_components = arena.allocate_array<T>(capacity);
+        m_capacity = capacity;
+        m_size = 0;
+        assert(m_sparse != nullptr and m_entities != nullptr and m_components != nullptr);
+
+        // has() reads it before add() writes it; the arena hands memory back uninitialised
+        memset(m_sparse, 0, sizeof(uint32_t) * capacity);
+    };
+
+    T& add(EntityId entity, const T& component = T())
+    {
+        assert(entity < m_capacity);
+        if (has(entity)) return m_components[m_sparse[entity]] = component;
+
+        m_sparse[entity] = m_size;
+        m_entities[m_size] = entity;
+        return *new (&m_components[m_size++]) T(component);
+    };
+
+    void remove(EntityId entity)
+    {
+        if (!has(entity)) return;
+
+        uint32_t slot = m_sparse[entity];
+        uint32_t last = --m_size;
+        m_components[slot] = m_components[last];
+        m_entities[slot] = m_entities[last];
+        m_sparse[m_entities[slot]] = slot;
+    };
+
+    void clear() { m_size = 0; };
+
+    bool has(EntityId entity) const
+    {
+        if (entity >= m_capacity) return false;
+        uint32_t slot = m_sparse[entity];
+        return slot < m_size && m_entities[slot] == entity;
+    };
+    T&   get(EntityId entity)       { return m_components[m_sparse[entity]]; };
+    T*   find(EntityId entity)      { return has(entity) ? &m_components[m_sparse[entity]] : nullptr; };
+
+    // dense iteration: for (int i = 0; i < pool.size(); i++) pool[i], pool.entity_at(i)
+    int      size()             const { return (int)m_size; };
+    T&       operator[](int i)        { return m_components[i]; };
+    EntityId entity_at(int i)   const { return m_entities[i]; };
+};
+
+/**
+* Every entity in the game: an entity is only an id, and is whatever set of
+* components has been added for it. Ids of destroyed entities are reused.
+*
+* Everything lives in the Arena given to load(), sized for at most max_entities
+* alive at once. clear() is O(1); so is starting over with a reset arena and a
+* fresh load(), which is how a new run begins.
+**/
+class World
+{
+private:
+    EntityId* m_free_ids = nullptr;
+    int       m_free_count = 0;
+    EntityId  m_next_id = 0;
+    int       m_capacity = 0;
+
+public:
+    ComponentPool<Transform>     transforms;
+    ComponentPool<Interpolation> interpolations;
+    ComponentPool<Motion>        motions;
+    ComponentPool<Collider>      colliders;
+    ComponentPool<Solid>         solids;
+    ComponentPool<Sprite>        sprites;
+    ComponentPool<Animation>     animations;
+
+    void     load(Arena& arena, int max_entities);
+    EntityId create();
+    void     destroy(EntityId entity);
+    void     clear();
+};
@@ -9,7 +9,6 @@
 **/
 
 #define LOG(argument) std::cout << argument << '\n'
-#define STB_IMAGE_IMPLEMENTATION
 #define GL_SILENCE_DEPRECATION
 #define GL_GLEXT_PROTOTYPES 1
 
@@ -22,23 +21,37 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
-#include "stb_image.h"
 #include "cmath"
 #include <ctime>
 #include <vector>
-#include "Entity.h"
-
-//  STRUCTS AND ENUMS //
-struct GameState
-{
-    Entity* background;
-    Entity* terrain;
-    Entity* player;
-    Entity* flame;
-    Entity* landingPads;
-    Entity* letters;
-    Entity* endText;
-};
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include "RenderThread.h"
+#include "Arena.h"
+#include "World.h"
+#include "Level.h"
+#include "InputRing.h"
+#include "Sequence.h"
+#include "GameClock.h"
+#include "HotReloader.h"
+#include "Benchmark.h"
+#include "InputSession.h"
+#include "ReplayReport.h"
+#include "Telemetry.h"
+#include "Profiler.h"
+#include "GLStats.h"
+#include "AllocationTracker.h"
+#include "Systems.h"
+#include "JobSystem.h"
+#include "HeadlessContext.h"
+#include "FrameRecorder.h"
+#include "QuadMesh.h"
+#include "ParticleSystem.h"
+#include "Texture.h"
+#include "TerrainStreamer.h"
+#include "Collision.h"
+#include "ProceduralTerrain.h"
 
 //  CONSTANTS  //
 
@@ -60,146 +73,410 @@ const int VIEWPORT_X = 0,
 
 // shader filepaths
 const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
-           F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
-
-// sprite filepaths
-const char BACKGROUND_FILEPATH[] = "assets/background.png",
-           TERRAIN_FILEPATH[] = "assets/terrain.png",
-           PLAYER_FILEPATH[] = "assets/kerbal_head.png",
-           FLAME_FILEPATH[] = "assets/flame.png",
-           LANDINGPAD_FILEPATH[] = "assets/landing_pad.png",
+           F_SHADER_PATH[] = "shaders/fragment_textured.glsl",
+           V_PARTICLE_SHADER_PATH[] = "shaders/vertex_particle.glsl",
+           F_PARTICLE_SHADER_PATH[] = "shaders/fragment_particle.glsl";
+
+// sprite filepaths; the rest come from the level
+const char TERRAIN_CACHE_DIRECTORY[] = "terrain_cache",
            LETTERSHEET_FILEPATH[] = "assets/default_font.png",
            VICTORY_FILEPATH[] = "assets/you_win.png",
            CRASHED_FILEPATH[] = "assets/you_lose.png";
 
 // world constants
-const float MILLISECONDS_IN_SECOND = 1000.0;
-const float FIXED_TIMESTEP = 0.0166666f;
-const float ACC_OF_GRAVITY = -0.08f;
-
-// texture generation stuff
-const int NUMBER_OF_TEXTURES = 1;  // to be generated, that is
-const GLint LEVEL_OF_DETAIL = 0;  // base image level; Level n is the nth mipmap reduction image
-const GLint TEXTURE_BORDER = 0;  // this value MUST be zero
+const uint64_t NANOSECONDS_IN_MILLISECOND = 1000000;
+const uint64_t FIXED_TIMESTEP_NS = NANOSECONDS_IN_SECOND / 60;
+const float FIXED_TIMESTEP = (float)FIXED_TIMESTEP_NS / NANOSECONDS_IN_SECOND;
+const int MAX_STEPS_PER_FRAME = 8;  // beyond this a frame gives up on catching up; see GameClock
+
+// world layout: a row of screen-sized terrain chunks, starting at the left edge of the first screen;
+// the level says how many
+const float SCREEN_HALF_WIDTH = 5.0f,
+            SCREEN_HALF_HEIGHT = 3.75f;
+const float CHUNK_WIDTH = 2 * SCREEN_HALF_WIDTH,
+            CHUNK_HEIGHT = 2 * SCREEN_HALF_HEIGHT;
+const float WORLD_MIN_X = -SCREEN_HALF_WIDTH;
+const int STREAMING_RADIUS = 1;  // chunks kept loaded on each side of the camera's
+
+// headless recording
+const int HEADLESS_FRAMES_PER_SECOND = 60;  // fixed frame rate of the offscreen clock and output video
 
 // custom
-const float THRUSTER_FORCE = 0.3f;
-const float GROUND_OFFSET = 0.8f;
-const float SAFE_SPEED = 0.35f;
+const float ENDING_DURATION = 4.0f;  // seconds the result stays up before the game closes
 const int LETTER_COUNT = 9;
-const int LANDINGPAD_COUNT = 4;
-const glm::vec3 PAD_COORDINATES[] = {
-    glm::vec3(-3.9f,-2.4f,0.0f),
-    glm::vec3(1.55f,-2.35f,0.0f),
-    glm::vec3(-1.9f,-0.95f,0.0f),
-    glm::vec3(4.05f,-1.2f,0.0f),
+const int MAX_LANDINGPAD_COUNT = LEVEL_MAX_PADS_PER_CHUNK * (2 * STREAMING_RADIUS + 3);
+const float LANDINGPAD_WIDTH = 0.35f,
+            LANDINGPAD_HEIGHT = 0.7f,
+            LANDINGPAD_STANDING_HEIGHT = 0.3f;  // how far the top of a generated pad stands above the ground
+const unsigned char LANDER_HULL_ALPHA = 128;    // pixels of the lander's image at least this opaque are solid
+
+// particles
+const int PARTICLE_CAPACITY = 100000;
+const float GROUND_SAMPLES_PER_UNIT = 51.2f;  // resolution of the terrain table particles bounce on
+const int GROUND_SAMPLES_PER_JOB = 256;
+const float PARTICLE_GRAVITY = -1.5f;    // heavier than the lander's so debris settles quickly
+const float PARTICLE_DRAG = 0.8f;
+const float PARTICLE_SIZE = 6.0f;        // pixels, at full life
+const int EXHAUST_PER_STEP = 12;
+const float EXHAUST_SPEED = 1.2f;
+const float EXHAUST_LIFETIME = 0.9f;
+const int DEBRIS_COUNT = 600;
+const float DEBRIS_SPEED = 1.5f;
+const float DEBRIS_LIFETIME = 3.0f;
+
+// benchmarks
+const int BENCHMARK_RUN_STEPS = 300;        // a run is restarted this often, so every step is in flight
+const int BENCHMARK_GROUND_QUERIES = 1024;  // per iteration, spread across the resident chunks
+
+// replays
+const char TRAINING_CORPUS_FILEPATH[] = "replays/corpus.txt";  // what --train plays unless it names another corpus
+
+// profiling
+const char PROFILE_TRACE_FILEPATH[] = "profile_trace.json";  // where F2 writes unless --profile names a file
+const float OVERLAY_CHARACTER_WIDTH = 0.2f;   // the overlays' text is set like the fuel counter's
+const float OVERLAY_CHARACTER_SIZE = 0.4f;
+const float OVERLAY_LINE_HEIGHT = 0.3f;
+
+// per-run memory
+const int MAX_ENTITY_COUNT = 64;
+const size_t RUN_ARENA_SIZE = 16 * 1024;  // bytes; World::load() peaks at 13,376 of it on x64 (F5 shows the peak)
+
+//  STRUCTS AND ENUMS //
+struct GameState
+{
+    EntityId background;
+    EntityId player;
+    EntityId flame;
+    EntityId landingPads[MAX_LANDINGPAD_COUNT];
+    EntityId letters[LETTER_COUNT];
+    EntityId endText;
 };
 
+// the shaders that can be reloaded, as ShaderReload numbers them
+enum ReloadableShader { SHADER_SPRITES, SHADER_PARTICLES };
+
 // VARIABLES  //
 
 // game state container
+Arena g_runArena;  // owns everything that only lasts one run; rewound by start_run()
+World g_world;
 GameState g_gameState;
+GLuint g_backgroundTexture, g_playerTexture, g_flameTexture, g_padTexture, g_letterTexture;
 
 // core globals
 SDL_Window* g_displayWindow;
+SDL_GLContext g_glContext;
+RenderThread g_renderThread;
+JobSystem g_jobs;
+int g_jobThreadCount = -1;  // workers besides the simulation thread; -1 = one per spare core
 ShaderProgram g_shaderProgram;
+QuadMesh g_quadMesh;
+ParticleSystem g_particles;
+ProceduralTerrainSource g_proceduralTerrain;
+ImageTerrainSource g_authoredTerrain;
+TerrainStreamer g_terrain;
 glm::mat4 g_viewMatrix, g_projectionMatrix;
 bool g_gameIsRunning = true;
+float g_worldMaxX = 0.0f;
+float g_cameraX = 0.0f;
+int g_landingPadCount = 0;  // how many of the pad entities belong to resident chunks
+
+// headless mode
+bool g_headless = false;
+HeadlessContext g_headlessContext;
+FrameRecorder g_frameRecorder;
+FrameSinkFormat g_videoFormat = SINK_Y4M;
+const char* g_videoPath = NULL;
+int g_frameLimit = 0;  // 0 = record until the run ends
+int g_framesPublished = 0;
+
+// level
+Level g_level;  // the built-in defaults unless --level says otherwise
+const char* g_levelPath = NULL;
+
+// benchmarks
+const char* g_benchmarkPath = NULL;  // set: measure, write the results here and exit
+
+// input sessions
+InputSession g_session;
+const char* g_recordPath = NULL;          // set: the keyboard is recorded into g_session and saved here at exit
+bool g_replaying = false;                 // g_session is being played back instead of read from the keyboard
+const char* g_replayCorpusPath = NULL;    // set: every session listed here is replayed and measured
+const char* g_replayResultsPath = NULL;
+const char* g_replayBaselinePath = NULL;  // set: the results are compared with these
+const char* g_trainingCorpusPath = NULL;  // set: every session listed here is played, unmeasured, for a PGO build to learn from
+
+// telemetry
+Telemetry g_telemetry;  // every step and every run's ending, for sweeps; off unless --telemetry names a file
+const char* g_telemetryPath = NULL;
+
+// hot reload
+bool g_watchAssets = false;
+HotReloader g_hotReloader;
+
+// profiling
+const char* g_tracePath = PROFILE_TRACE_FILEPATH;  // written at exit while the profiler is recording
+bool g_showFrameTimes = false;                     // the percentile overlay, toggled with F3
+bool g_showGLStats = false;                        // the GL call counts, toggled with F4
+bool g_showAllocations = false;                    // heap use, toggled with F5; needs KERBAL_TRACK_ALLOCATIONS
+int64_t g_frameAllocations = 0;                    // heap allocations made during the last frame, on every thread
+
+// terrain; these two start out as the level's, unless given on the command line
+bool g_authoredTerrainMode = false;
+uint32_t g_terrainSeed = 0;
+const char* g_terrainCacheDirectory = TERRAIN_CACHE_DIRECTORY;  // NULL = always regenerate
 
 // times
-float g_previousTicks = 0.0f;
-float g_timeAccumulator = 0.0f;
+SystemTimeSource g_systemTime;
+VirtualTimeSource g_virtualTime;  // offscreen runs: one video frame per loop
+GameClock g_clock;
+int g_maxStepsPerFrame = MAX_STEPS_PER_FRAME;
+Uint32 g_lastEventTicks = 0;    // the last SDL timestamp placed on the clock, starting with when it started
+uint64_t g_lastEventMs = 0;     // ...and where on the clock it went, which keeps counting past a 32-bit wrap
 
 // custom
 bool g_tooFast = false;
 bool g_thrusterOn = false;
+InputRing g_inputRing;    // key events, filled by process_input() and drained a fixed step at a time
+InputState g_inputState;  // the controls held as of the last event drained
 bool g_showEndText = false;
-float g_endingTimer = 4.0f;
-float g_fuel = 3000;
+bool g_restartRequested = false;
+SequenceScheduler g_sequences;
+SequenceSignal g_runEnded;  // fired by end_game(), the first time only
+GLuint g_victoryTexture, g_crashedTexture;
+float g_fuel = 0.0f;
+ConvexHull g_landerHull;  // traced from the lander's image; what hits the ground
 
 //  GENERAL FUNCTIONS  //
-GLuint load_texture(const char* filepath)
-{
-    int width, height, number_of_components;
-    unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+void add_acceleration(EntityId entity, glm::vec2 force) {
+    g_world.motions.get(entity).acceleration += force;
+}
 
-    if (image == NULL)
-    {
-        LOG("Unable to load image. Make sure the path is correct.");
-        assert(false);
-    }
+float get_ground_level(float xPos) {
+    // the surface height is traced from whichever terrain chunk lies under xPos
+    return g_terrain.get_ground_level(xPos);
+}
 
-    GLuint textureID;
-    glGenTextures(NUMBER_OF_TEXTURES, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
+float get_camera_x(float playerX) {
+    // follow the lander, but never show anything past the ends of the world
+    return glm::clamp(playerX, WORLD_MIN_X + SCREEN_HALF_WIDTH, g_worldMaxX - SCREEN_HALF_WIDTH);
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+void refresh_streamed_world() {
+    //  LANDING PADS  //
+    // pads come and go with their chunks
+    for (int i = 0; i < g_landingPadCount; i++) g_world.destroy(g_gameState.landingPads[i]);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glm::vec3 padPositions[MAX_LANDINGPAD_COUNT];
+    g_landingPadCount = g_terrain.collect_pads(padPositions, MAX_LANDINGPAD_COUNT);
 
-    stbi_image_free(image);
+    for (int i = 0; i < g_landingPadCount; i++) {
+        EntityId pad = g_world.create();
+        Transform& transform = g_world.transforms.add(pad);
+        transform.position = glm::vec2(padPositions[i]);
+        transform.scale = glm::vec2(LANDINGPAD_WIDTH, LANDINGPAD_HEIGHT);
 
-    return textureID;
-}
+        Sprite sprite;
+        sprite.texture_id = g_padTexture;
+        sprite.layer = LAYER_PADS;
+        g_world.sprites.add(pad, sprite);
+        g_world.solids.add(pad);
+
+        g_gameState.landingPads[i] = pad;
+    }
+
+    //  PARTICLE GROUND  //
+    static std::vector<float> groundHeights;
+    float minX, maxX;
+    g_terrain.get_resident_range(&minX, &maxX);
 
-void add_acceleration(Entity* entity, glm::vec3 force) {
-    glm::vec3 acc = entity->get_acceleration();
-    acc.x += force.x;
-    acc.y += force.y;
-    acc.z += force.z;
-    entity->set_acceleration(acc);
+    groundHeights.resize((int)((maxX - minX) * GROUND_SAMPLES_PER_UNIT));
+
+    // every sample is independent, and only reads chunks that are already resident
+    struct GroundSamples { float* heights; float minX; } samples = { groundHeights.data(), minX };
+    JobCounter counter;
+    g_jobs.parallel_for((int)groundHeights.size(), GROUND_SAMPLES_PER_JOB, [](void* data, int begin, int end) {
+        GroundSamples* samples = (GroundSamples*)data;
+        for (int i = begin; i < end; i++) {
+            samples->heights[i] = g_terrain.get_resident_ground_level(samples->minX + (i + 0.5f) / GROUND_SAMPLES_PER_UNIT);
+        }
+    }, &samples, &counter);
+    g_jobs.wait(&counter);
+    g_particles.set_ground(groundHeights.data(), (int)groundHeights.size(), minX, maxX);
 }
 
-float get_ground_level(float xPos) {
-    // determines where the ground is based on a really big piecewise function
-    // the function is available here: https://www.desmos.com/calculator/gs3nqgoldy
-    float output = -3.75f;
-    if (-5.0f < xPos and xPos < -4.143f) output = -0.1f * xPos - 3.0f;
-    else if (xPos < -3.918f) output = -3.6f * xPos - 17.5f;
-    else if (xPos < -3.533f) output = 2.5f * xPos + 6.4f;
-    else if (xPos < -2.727f) output = -0.5f * xPos - 4.2f;
-    else if (xPos < -1.926f) output = 1.7f * xPos + 1.8f;
-    else if (xPos < -0.643f) output = -1.0f * xPos - 3.4f;
-    else if (xPos < 0.125f) output = 0.4f * xPos - 2.5f;
-    else if (xPos < 1.5f) output = -0.4f * xPos - 2.4f;
-    else if (xPos < 2.813f) output = 0.2f * xPos - 3.3f;
-    else if (xPos < 3.741f) output = 1.8f * xPos - 7.8f;
-    else if (xPos < 4.143f) output = -3.6f * xPos + 12.4f;
-    else if (xPos < 5.0f) output = -0.1f * xPos - 2.1f;
-    else {
-        LOG("Invalid X position!");
-        assert(false);
-    }
-    return output;
+LanderState get_lander_state() {
+    const Transform& transform = g_world.transforms.get(g_gameState.player);
+    const Motion& motion = g_world.motions.get(g_gameState.player);
+    return { transform.position, motion.velocity, transform.angle, g_fuel, g_tooFast, g_thrusterOn };
 }
 
 void end_game(bool success) {
-    g_gameState.endText = new Entity();
-    if (success) g_gameState.endText->m_texture_id = load_texture(VICTORY_FILEPATH);
-    else g_gameState.endText->m_texture_id = load_texture(CRASHED_FILEPATH);
-    g_gameState.endText->set_width(10.0f);
-    g_gameState.endText->set_height(7.5f);
-    g_gameState.endText->update(0.0f, NULL, 0);
+    // the velocity it hit the ground at; simulate_step() only zeroes it after this
+    if (!g_showEndText) g_telemetry.end_episode(success ? OUTCOME_LANDED : OUTCOME_CRASHED, get_lander_state());
+
+    // blow the lander apart, but only the first time the crash is detected
+    if (!success and !g_showEndText) {
+        g_particles.emit(g_world.transforms.get(g_gameState.player).position, glm::vec2(DEBRIS_SPEED, 0.0f),
+                         360.0f, 0.8f, DEBRIS_LIFETIME, TINT_DEBRIS, DEBRIS_COUNT);
+    }
+
+    if (!g_showEndText) g_sequences.fire(g_runEnded);
+
+    // loaded up front: only the GL thread may create textures once the game is running
+    Sprite& endText = g_world.sprites.get(g_gameState.endText);
+    endText.texture_id = success ? g_victoryTexture : g_crashedTexture;
+    endText.visible = true;
     g_showEndText = true;
 }
 
+//  SEQUENCES  //
+Sequence run_ending() {
+    // dormant until end_game(): the result stays up for a while, then the game closes
+    co_await g_sequences.wait_for(g_runEnded);
+    co_await g_sequences.wait_seconds(ENDING_DURATION);
+    g_gameIsRunning = false;
+}
+
+void start_run()
+{
+    // a restart before the last run ended
+    if (g_telemetry.in_episode()) g_telemetry.end_episode(OUTCOME_ABANDONED, get_lander_state());
+
+    // everything the last run created goes at once: the arena is rewound and the
+    // world re-carved from it, without touching any of the old entities
+    g_runArena.reset();
+    g_world.load(g_runArena, MAX_ENTITY_COUNT);
+    g_landingPadCount = 0;
+    g_particles.clear();
+    g_sequences.clear();
+
+    g_tooFast = false;
+    g_thrusterOn = false;
+    g_showEndText = false;
+    g_restartRequested = false;
+    const LevelData& level = g_level.get();
+    g_fuel = level.fuel;
+
+    //  BACKGROUND  //
+    g_gameState.background = g_world.create();
+    g_world.transforms.add(g_gameState.background).scale = glm::vec2(10.0f, 7.5f);
+    g_world.sprites.add(g_gameState.background).texture_id = g_backgroundTexture;
+
+    //  PLAYER  //
+    // setup basic attributes
+    g_gameState.player = g_world.create();
+    Transform& playerTransform = g_world.transforms.add(g_gameState.player);
+    playerTransform.angle = level.spawn_angle;
+    playerTransform.position = level.spawn_position;
+
+    Motion& playerMotion = g_world.motions.add(g_gameState.player);
+    playerMotion.velocity = level.spawn_velocity;
+    playerMotion.acceleration = glm::vec2(0.0f, level.gravity);
+    playerMotion.rotation_speed = 1.0f;
+
+    g_world.colliders.add(g_gameState.player);
+    g_world.interpolations.add(g_gameState.player);
+    g_telemetry.start_episode();
+
+    // setup visuals
+    playerTransform.scale = glm::vec2(0.4f, 0.35f);
+    Sprite& playerSprite = g_world.sprites.add(g_gameState.player);
+    playerSprite.texture_id = g_playerTexture;
+    playerSprite.layer = LAYER_PLAYER;
+
+    //  FLAME  //
+    // follows the player around; has no motion of its own
+    g_gameState.flame = g_world.create();
+    g_world.transforms.add(g_gameState.flame).scale = glm::vec2(0.25f, 0.6f);
+    g_world.interpolations.add(g_gameState.flame);
+    Sprite& flameSprite = g_world.sprites.add(g_gameState.flame);
+    flameSprite.texture_id = g_flameTexture;
+    flameSprite.layer = LAYER_FLAME;
+    flameSprite.visible = false;
+
+    //  ENDING TEXT  //
+    g_gameState.endText = g_world.create();
+    g_world.transforms.add(g_gameState.endText).scale = glm::vec2(10.0f, 7.5f);
+    Sprite& endTextSprite = g_world.sprites.add(g_gameState.endText);
+    endTextSprite.layer = LAYER_OVERLAY;
+    endTextSprite.visible = false;
+
+    //  DISPLAY LETTERS  //
+    char message[] = "FUEL 0000";
+
+    for (int i = 0; i < LETTER_COUNT; i++) {
+        EntityId letter = g_world.create();
+        Transform& transform = g_world.transforms.add(letter);
+        transform.position = glm::vec2(-4.6f + i*0.2f, -3.3f);
+        transform.scale = glm::vec2(0.4f, 0.4f);
+
+        Sprite& sprite = g_world.sprites.add(letter);
+        sprite.texture_id = g_letterTexture;
+        sprite.layer = LAYER_HUD;
+
+        // the font is a 16x16 grid of characters in ASCII order
+        Animation& animation = g_world.animations.add(letter);
+        animation.columns = 16;
+        animation.rows = 16;
+        animation.frame = message[i];
+
+        g_gameState.letters[i] = letter;
+    }
+    update_animation(g_world, 0.0f);
+
+    //  SEQUENCES  //
+    {
+        ALLOCATION_SCOPE(ALLOC_SEQUENCES);
+        g_sequences.start(run_ending());
+    }
+
+    //  LANDING PADS  //
+    // pads come with their chunks, so the world streams in around the lander's start
+    g_cameraX = get_camera_x(playerTransform.position.x);
+    g_terrain.update(g_cameraX);
+    refresh_streamed_world();
+}
+
 void initialise()
 {
-    SDL_Init(SDL_INIT_VIDEO);
-    g_displayWindow = SDL_CreateWindow("Kerbal Landing",
-        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-        WINDOW_WIDTH, WINDOW_HEIGHT,
-        SDL_WINDOW_OPENGL);
+    if (g_headless) {
+        // no window at all: draw into an FBO and stream the frames out
+        if (!g_headlessContext.load() or
+            !g_frameRecorder.load(WINDOW_WIDTH, WINDOW_HEIGHT, HEADLESS_FRAMES_PER_SECOND, g_videoFormat, g_videoPath))
+        {
+            LOG("Unable to start headless rendering.");
+            assert(false);
+        }
+        g_frameRecorder.bind();
+    }
+    else {
+        SDL_Init(SDL_INIT_VIDEO);
+
+        // core profile only: no client-side arrays, no fixed function
+#ifdef KERBAL_GLES
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+#else
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+#endif
+
+        g_displayWindow = SDL_CreateWindow("Kerbal Landing",
+            SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+            WINDOW_WIDTH, WINDOW_HEIGHT,
+            SDL_WINDOW_OPENGL);
 
-    SDL_GLContext context = SDL_GL_CreateContext(g_displayWindow);
-    SDL_GL_MakeCurrent(g_displayWindow, context);
+        g_glContext = SDL_GL_CreateContext(g_displayWindow);
+        SDL_GL_MakeCurrent(g_displayWindow, g_glContext);
 
 #ifdef _WINDOWS
-    glewInit();
+        glewExperimental = GL_TRUE;  // otherwise GLEW skips core-profile entry points
+        glewInit();
 #endif
+    }
 
     glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
 
@@ -211,85 +488,152 @@ void initialise()
     g_shaderProgram.set_projection_matrix(g_projectionMatrix);
     g_shaderProgram.set_view_matrix(g_viewMatrix);
 
-    glUseProgram(g_shaderProgram.get_program_id());
+    gl_use_program(g_shaderProgram.get_program_id());
+
+    // every sprite is this one quad; bind it once and leave it bound
+    g_quadMesh.load(ShaderProgram::POSITION_ATTRIBUTE, ShaderProgram::TEX_COORD_ATTRIBUTE);
+    g_quadMesh.bind();
 
     glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
 
-    //  BACKGROUND  //
-    g_gameState.background = new Entity();
-    g_gameState.background->m_texture_id = load_texture(BACKGROUND_FILEPATH);
-    g_gameState.background->set_width(10.0f);
-    g_gameState.background->set_height(7.5f);
-    g_gameState.background->update(0.0f, NULL, 0);
+    //  TEXTURES  //
+    // loaded once, for every run; only the GL thread may create textures once the game is running
+    const LevelData& level = g_level.get();
+    g_backgroundTexture = load_texture(level.background_path);
+    g_playerTexture = load_texture(level.player_path);
+    g_flameTexture = load_texture(level.flame_path);
+    g_victoryTexture = load_texture(VICTORY_FILEPATH);
+    g_crashedTexture = load_texture(CRASHED_FILEPATH);
+    g_padTexture = load_texture(level.landing_pad_path);
+    g_letterTexture = load_texture(LETTERSHEET_FILEPATH);
+
+    //  LANDER OUTLINE  //
+    int hullWidth, hullHeight;
+    unsigned char* playerPixels = load_image_pixels(level.player_path, &hullWidth, &hullHeight);
+    if (playerPixels == NULL or !build_alpha_hull(playerPixels, hullWidth, hullHeight, LANDER_HULL_ALPHA, g_landerHull)) {
+        LOG("Unable to trace the lander's outline: " << level.player_path);
+        assert(false);
+    }
+    if (playerPixels != NULL) free_image_pixels(playerPixels);
 
-    //  TERRAIN  //
-    g_gameState.terrain = new Entity();
-    g_gameState.terrain->m_texture_id = load_texture(TERRAIN_FILEPATH);
-    g_gameState.terrain->set_width(10.0f);
-    g_gameState.terrain->set_height(7.5f);
-    g_gameState.terrain->update(0.0f, NULL, 0);
+    //  JOBS  //
+    g_jobs.load(g_jobThreadCount);
 
-    //  PLAYER  //
-    // setup basic attributes
-    g_gameState.player = new Entity();
-    g_gameState.player->set_angle(-90.0f);
-    g_gameState.player->set_position(glm::vec3(-4.6f, 3.4f, 0.0f));
-    g_gameState.player->set_velocity(glm::vec3(0.4f, 0.0f, 0.0f));
-    g_gameState.player->set_acceleration(glm::vec3(0.0f, ACC_OF_GRAVITY, 0.0f));
-    g_gameState.player->m_texture_id = load_texture(PLAYER_FILEPATH);
-    g_gameState.player->set_rot_speed(1.0f);
-    g_gameState.player->m_jumping_power = 3.0f;
-    g_gameState.player->m_control_mode = 2;
+    //  PARTICLES  //
+    g_particles.load(PARTICLE_CAPACITY, V_PARTICLE_SHADER_PATH, F_PARTICLE_SHADER_PATH);
+    g_quadMesh.bind();
 
-    // setup visuals
-    g_gameState.player->set_height(0.35f);
-    g_gameState.player->set_width(0.4f);
+    //  TERRAIN  //
+    // generated from the seed unless the hand-drawn chunks were asked for
+    TerrainSource* terrainSource = &g_authoredTerrain;
+    if (g_authoredTerrainMode) {
+        glm::vec3 pads[LEVEL_MAX_PADS_PER_CHUNK];
+        for (int i = 0; i < level.image_pad_count; i++) pads[i] = glm::vec3(level.image_pads[i], 0.0f);
+        g_authoredTerrain.load(level.terrain_pattern, level.terrain_fallback_path, pads, level.image_pad_count);
+    }
+    else {
+        ProceduralTerrainParams terrainParams;
+        terrainParams.base_height = level.base_height;
+        terrainParams.min_height = level.min_height;
+        terrainParams.max_height = level.max_height;
+        terrainParams.roughness = level.roughness;
+        terrainParams.pads_per_chunk = level.pads_per_chunk;
+        terrainParams.pad_flat_half_width = level.pad_flat_half_width;
+        terrainParams.pad_ramp_width = level.pad_ramp_width;
+        terrainParams.pad_centre_offset = LANDINGPAD_STANDING_HEIGHT - LANDINGPAD_HEIGHT / 2.0f;
+        terrainParams.pixel_width = WINDOW_WIDTH;
+        terrainParams.pixel_height = WINDOW_HEIGHT;
+        g_proceduralTerrain.load(g_terrainSeed, g_terrainCacheDirectory, terrainParams);
+        terrainSource = &g_proceduralTerrain;
+    }
+    g_worldMaxX = WORLD_MIN_X + level.chunk_count * CHUNK_WIDTH;
+    g_terrain.load(terrainSource, level.chunk_count, WORLD_MIN_X, CHUNK_WIDTH, CHUNK_HEIGHT, STREAMING_RADIUS);
+
+    //  HOT RELOAD  //
+    // every name above stays the same for the whole session, so a changed file only
+    // has to replace what's behind it
+    if (g_watchAssets) {
+        g_hotReloader.watch_texture(level.background_path, g_backgroundTexture);
+        g_hotReloader.watch_texture(level.player_path, g_playerTexture, LANDER_HULL_ALPHA);
+        g_hotReloader.watch_texture(level.flame_path, g_flameTexture);
+        g_hotReloader.watch_texture(VICTORY_FILEPATH, g_victoryTexture);
+        g_hotReloader.watch_texture(CRASHED_FILEPATH, g_crashedTexture);
+        g_hotReloader.watch_texture(level.landing_pad_path, g_padTexture);
+        g_hotReloader.watch_texture(LETTERSHEET_FILEPATH, g_letterTexture);
+        g_hotReloader.watch_shader(SHADER_SPRITES, V_SHADER_PATH, F_SHADER_PATH);
+        g_hotReloader.watch_shader(SHADER_PARTICLES, V_PARTICLE_SHADER_PATH, F_PARTICLE_SHADER_PATH);
+        if (g_levelPath != NULL) g_hotReloader.watch_level(g_levelPath);
+        g_hotReloader.start();
+        LOG("Watching assets for changes" << (g_hotReloader.is_polling() ? " (polling)." : "."));
+    }
 
-    //  FLAME  //
-    g_gameState.flame = new Entity();
-    g_gameState.flame->m_texture_id = load_texture(FLAME_FILEPATH);
-    g_gameState.flame->set_width(0.25f);
-    g_gameState.flame->set_height(0.6f);
+    //  FIRST RUN  //
+    g_runArena.load(RUN_ARENA_SIZE);
+    start_run();
 
-    //  LANDING PADS  //
-    g_gameState.landingPads = new Entity[LANDINGPAD_COUNT];
+    //  GENERAL  //
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
 
-    for (int i = 0; i < LANDINGPAD_COUNT; i++)
-    {
-        g_gameState.landingPads[i].m_texture_id = load_texture(LANDINGPAD_FILEPATH);
-        g_gameState.landingPads[i].set_position(PAD_COORDINATES[i]);
-        g_gameState.landingPads[i].set_width(0.35f);
-        g_gameState.landingPads[i].set_height(0.7f);
-        g_gameState.landingPads[i].update(0.0f, NULL, 0);
+uint64_t get_event_time_ns(Uint32 timestamp) {
+    // SDL stamps events in 32-bit milliseconds from when it started, which wrap after
+    // 49.7 days; stepping on from the last timestamp by the wrapped difference doesn't
+    int32_t sinceLastEvent = (int32_t)(Uint32)(timestamp - g_lastEventTicks);
+    if (sinceLastEvent > 0) {
+        g_lastEventTicks = timestamp;
+        g_lastEventMs += (uint64_t)sinceLastEvent;
     }
+    // (anything stamped before the clock started, or out of order, lands on the last time)
+    return g_lastEventMs * NANOSECONDS_IN_MILLISECOND;
+}
 
-    //  DISPLAY LETTERS  //
-    g_gameState.letters = new Entity[LETTER_COUNT];
-    char message[] = "FUEL 0000";
+uint64_t get_headless_time_ns() {
+    // offscreen runs advance exactly one video frame per loop, however long it took to draw
+    return g_framesPublished * NANOSECONDS_IN_SECOND / HEADLESS_FRAMES_PER_SECOND;
+}
 
-    for (int i = 0; i < LETTER_COUNT; i++) {
-        g_gameState.letters[i].m_texture_id = load_texture(LETTERSHEET_FILEPATH);
-        g_gameState.letters[i].m_animation_indices = new int[256];
-        for (int j = 0; j < 256; j++) g_gameState.letters[i].m_animation_indices[j] = j;
-        g_gameState.letters[i].m_animation_index = message[i];
-        g_gameState.letters[i].m_animation_cols = 16;
-        g_gameState.letters[i].m_animation_rows = 16;
-        g_gameState.letters[i].set_width(0.4f);
-        g_gameState.letters[i].set_height(0.4f);
-        g_gameState.letters[i].set_position(glm::vec3(-4.6f + i*0.2f, -3.3f, 0.0f));
-        g_gameState.letters[i].update(0.0f, NULL, 0);
+void play_session()
+{
+    // everything due by the time this frame's steps run to; apply_controls() sorts out which step sees what
+    SessionEvent event;
+    while (g_session.next_due(get_headless_time_ns(), &event)) {
+        switch (event.type) {
+        case SESSION_PRESS:
+        case SESSION_RELEASE:
+        {
+            InputEvent input = { event.time_ns, event.control, event.type == SESSION_PRESS };
+            if (!g_inputRing.push(input)) LOG("Input ring full; dropped a recorded key event.");
+            break;
+        }
+        case SESSION_RESTART:
+            g_restartRequested = true;
+            break;
+        case SESSION_END:
+            g_gameIsRunning = false;
+            break;
+        }
+    }
+}
+
+bool get_input_control(SDL_Scancode key, InputControl* control) {
+    switch (key) {
+    case SDL_SCANCODE_LEFT:  *control = INPUT_ROTATE_LEFT;  return true;
+    case SDL_SCANCODE_RIGHT: *control = INPUT_ROTATE_RIGHT; return true;
+    case SDL_SCANCODE_UP:    *control = INPUT_THRUST;       return true;
+    default:                 return false;
     }
-    
-    //  GENERAL  //
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 void process_input()
 {
-    // reset forced-movement if no player input
-    g_gameState.player->set_acceleration(glm::vec3(0.0f, ACC_OF_GRAVITY, 0.0f));
-    g_gameState.player->set_rotation(0.0f);
+    PROFILE_ZONE("process_input");
+
+    // there is nobody at the keyboard in headless mode, only a recorded session if there is one
+    if (g_headless) {
+        if (g_replaying) play_session();
+        return;
+    }
 
     SDL_Event event;
     while (SDL_PollEvent(&event))
@@ -306,194 +650,825 @@ void process_input()
                 g_gameIsRunning = false;
                 break;
 
+            case SDLK_r:
+                g_restartRequested = true;
+                if (g_recordPath != NULL) g_session.record(get_event_time_ns(event.key.timestamp), SESSION_RESTART);
+                break;
+
+            case SDLK_F2:
+                // the first press starts recording; each one after writes out what's been recorded
+                if (!Profiler::is_enabled()) {
+                    Profiler::set_enabled(true);
+                    LOG("Profiling; F2 again writes the trace to " << g_tracePath);
+                }
+                else if (Profiler::write_chrome_trace(g_tracePath)) {
+                    LOG("Trace written to " << g_tracePath);
+                }
+                break;
+
+            case SDLK_F3:
+                g_showFrameTimes = !g_showFrameTimes;
+                break;
+
+            case SDLK_F4:
+                g_showGLStats = !g_showGLStats;
+                break;
+
+            case SDLK_F5:
+                g_showAllocations = !g_showAllocations;
+                break;
+
             default:
                 break;
             }
+            // the controls are recorded on both edges
+            [[fallthrough]];
+
+        case SDL_KEYUP:
+        {
+            // stamped with when the key actually went, on the clock update() steps by,
+            // so each fixed step sees exactly the presses that happened before it ends
+            InputEvent input;
+            if (event.key.repeat or !get_input_control(event.key.keysym.scancode, &input.control)) break;
+            input.timestamp_ns = get_event_time_ns(event.key.timestamp);
+            input.pressed = event.type == SDL_KEYDOWN;
+            if (!g_inputRing.push(input)) LOG("Input ring full; dropped a key event.");
+            if (g_recordPath != NULL) g_session.record(input.timestamp_ns, input.pressed ? SESSION_PRESS : SESSION_RELEASE, input.control);
+            break;
+        }
 
         default:
             break;
         }
     }
+}
 
-    float angle = g_gameState.player->get_angle();
-    const Uint8* key_state = SDL_GetKeyboardState(NULL);
-    if (not g_showEndText) {
-        if (key_state[SDL_SCANCODE_LEFT])
-        {
-            if (angle < 90.0f) {
-                g_gameState.player->rotate_anticlockwise();
-            }
-        }
-        if (key_state[SDL_SCANCODE_RIGHT])
-        {
-            if (angle > -90.0f) {
-                g_gameState.player->rotate_clockwise();
-            }
-        }
-        if (key_state[SDL_SCANCODE_UP] and g_fuel > 0) {
-            g_thrusterOn = true;
-            glm::vec3 thrustVec = glm::vec3(
-                THRUSTER_FORCE * cos(glm::radians(angle + 90)),
-                THRUSTER_FORCE * sin(glm::radians(angle + 90)),
-                0.0f);
-            add_acceleration(g_gameState.player, thrustVec);
-            g_fuel -= 0.1f;
-        }
-        else {
-            g_thrusterOn = false;
+void apply_controls(uint64_t stepEndNs)
+{
+    // whatever was held by the end of this step is held for all of it
+    InputEvent input;
+    while (g_inputRing.pop_before(stepEndNs, &input)) g_inputState.apply(input);
+
+    // reset forced-movement if no player input
+    Motion& playerMotion = g_world.motions.get(g_gameState.player);
+    const LevelData& level = g_level.get();
+    playerMotion.acceleration = glm::vec2(0.0f, level.gravity);
+    playerMotion.rotation = 0.0f;
+    g_thrusterOn = false;
+    if (g_showEndText) return;
+
+    float angle = g_world.transforms.get(g_gameState.player).angle;
+    if (g_inputState.held[INPUT_ROTATE_LEFT] and angle < 90.0f) {
+        playerMotion.rotation = 1.0f;
+    }
+    if (g_inputState.held[INPUT_ROTATE_RIGHT] and angle > -90.0f) {
+        playerMotion.rotation = -1.0f;
+    }
+    if (g_inputState.held[INPUT_THRUST] and g_fuel > 0) {
+        g_thrusterOn = true;
+        glm::vec2 thrustVec = glm::vec2(
+            level.thruster_force * cos(glm::radians(angle + 90)),
+            level.thruster_force * sin(glm::radians(angle + 90)));
+        add_acceleration(g_gameState.player, thrustVec);
+
+        // by simulated time, so the tank lasts as long at any frame rate
+        g_fuel -= level.fuel_burn * FIXED_TIMESTEP;
+    }
+}
+
+void simulate_step()
+{
+    PROFILE_ZONE("simulate_step");
+
+    // one fixed step of the game; update() pays each one off the clock after
+    const LevelData& level = g_level.get();
+
+    // remember where the moving entities started this step, for render() to blend from
+    store_previous_transforms(g_world);
+
+    // steer with the input that arrived before this step ends
+    apply_controls(g_clock.get_step_end_ns());
+
+    // run whichever sequences are due; the rest cost nothing
+    g_sequences.advance(FIXED_TIMESTEP);
+    
+    // get player info
+    Transform& playerTransform = g_world.transforms.get(g_gameState.player);
+    Motion& playerMotion = g_world.motions.get(g_gameState.player);
+    glm::vec2 pos = playerTransform.position;
+    glm::vec2 vel = playerMotion.velocity;
+    float xOffset = playerTransform.scale.x / 2;
+    float yOffset = playerTransform.scale.y / 2;
+    float angle = playerTransform.angle;
+    
+    // check for wall collision
+    if (pos.x <= WORLD_MIN_X + xOffset or pos.x >= g_worldMaxX - xOffset) {
+        vel.x = 0.0f;
+        pos.x += (pos.x > WORLD_MIN_X + xOffset)? -0.01f : 0.01f;
+    }
+    if (pos.y >= 3.75f - yOffset) {
+        vel.y = 0.0f;
+        pos.y -= 0.01f;
+    }
+
+    // check for terrain collision: the lander's outline as drawn, turned however it is
+    PlacedHull hull;
+    place_hull(g_landerHull, pos, angle, playerTransform.scale, hull);
+    if (g_terrain.hull_hits_ground(hull)) {
+        vel = glm::vec2(0.0f);
+        end_game(false);
+    }
+
+    // check for successful landing
+    if (g_world.colliders.get(g_gameState.player).collided_bottom) {
+        vel = glm::vec2(0.0f);
+        if (angle > level.max_landing_angle or angle < -level.max_landing_angle or g_tooFast) {
+            end_game(false);
+        } else {
+            end_game(true);
         }
     }
-    else {
-        g_thrusterOn = false;
+
+    // check if player is moving slow enough to land
+    float currentSpeed = glm::length(vel);
+    g_tooFast = currentSpeed >= level.safe_speed;
+
+    // move the player
+    playerTransform.position = pos;
+    playerMotion.velocity = vel;
+    update_motion(g_world, FIXED_TIMESTEP);
+    if (g_telemetry.is_enabled()) g_telemetry.record_step(get_lander_state());
+
+    // reposition the flame
+    glm::vec2 flameOffset = glm::vec2(
+        0.4f * cos(glm::radians(angle - 90)),
+        0.4f * sin(glm::radians(angle - 90)));
+    Transform& flameTransform = g_world.transforms.get(g_gameState.flame);
+    flameTransform.set_position(playerTransform.position + flameOffset);
+    flameTransform.set_angle(angle);
+
+    // exhaust leaves the nozzle opposite the thrust, on top of the lander's own velocity
+    if (g_thrusterOn) {
+        glm::vec2 exhaustDirection = glm::vec2(cos(glm::radians(angle - 90)), sin(glm::radians(angle - 90)));
+        g_particles.emit(playerTransform.position + exhaustDirection * 0.25f,
+                         playerMotion.velocity + exhaustDirection * EXHAUST_SPEED,
+                         25.0f, 0.3f, EXHAUST_LIFETIME, TINT_EXHAUST, EXHAUST_PER_STEP);
     }
+    g_particles.update(FIXED_TIMESTEP, PARTICLE_GRAVITY, PARTICLE_DRAG, &g_jobs);
 
-    // normalize forced-movement vector so you don't go faster diagonally
-    if (glm::length(g_gameState.player->get_movement()) > 1.0f)
-    {
-        g_gameState.player->set_movement(glm::normalize(g_gameState.player->get_movement()));
+    // update the fuel counter
+    for (int i = 0; i < 4; i++) {
+        g_world.animations.get(g_gameState.letters[8-i]).frame = ( int(g_fuel) % int(pow(10,i+1)) ) / pow(10,i) + 48;
     }
+    update_animation(g_world, FIXED_TIMESTEP);
 }
 
 void update()
 {
+    PROFILE_ZONE("update");
+
+    // between steps, so nothing is holding on to the old level's data; the physics
+    // read it every step, but the rest was used up when the run or the game started
+    if (g_watchAssets and g_hotReloader.take_level(g_level)) {
+        LOG("Reloaded " << g_levelPath << ": physics apply now, the spawn and fuel from the next run (R), "
+            "terrain and asset paths from the next launch.");
+    }
+
+    // the same for the lander's outline, so it never changes under a step
+    if (g_watchAssets and g_hotReloader.take_hull(g_playerTexture, g_landerHull)) {
+        LOG("Traced the lander's outline again: " << g_landerHull.points.size() << " points.");
+    }
+
+    // between steps, so nothing is holding on to the old run's components
+    if (g_restartRequested) start_run();
+
     //  DELTA TIME  //
-    float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND; // get the current number of ticks
-    float delta_time = ticks - g_previousTicks; // the delta time is the difference from the last frame
-    g_previousTicks = ticks;
+    if (g_headless) g_virtualTime.set_time_ns(get_headless_time_ns());
 
     //  FIXED TIMESTEP  //
-    g_timeAccumulator += delta_time;
-    if (g_timeAccumulator < FIXED_TIMESTEP) return;
-    while (g_timeAccumulator >= FIXED_TIMESTEP)
+    int steps = g_clock.begin_frame();
+    if (steps == 0) return;
+    for (int step = 0; step < steps; step++)
     {
-        // handle game ending
-        if (g_showEndText) {
-            if ((g_endingTimer -= FIXED_TIMESTEP) <= 0) {
-                g_gameIsRunning = false;
-            }
-        }
-        
-        // get player info
-        glm::vec3 pos = g_gameState.player->get_position();
-        glm::vec3 vel = g_gameState.player->get_velocity();
-        float xOffset = g_gameState.player->get_width() / 2;
-        float yOffset = g_gameState.player->get_height() / 2;
-        float angle = g_gameState.player->get_angle();
-        
-        // check for wall collision
-        if (abs(pos.x) >= 5.0f - xOffset) {
-            vel.x = 0.0f;
-            pos.x += (pos.x > 0)? -0.01f : 0.01f;
-        }
-        if (pos.y >= 3.75f - yOffset) {
-            vel.y = 0.0f;
-            pos.y -= 0.01f;
-        }
-
-        // check for terrain collision
-        glm::vec3 collisionPoints[] = {
-            pos + glm::vec3(0.0f,0.0f-yOffset,0.0f),
-            pos + glm::vec3(-0.19f,0.1f-yOffset,0.0f),
-            pos + glm::vec3(0.19f,0.1f-yOffset,0.0f),
-        };
-        for (int i = 0; i < 3; i++) {
-            if (collisionPoints[i].y <= get_ground_level(collisionPoints[i].x) + GROUND_OFFSET) {
-                vel = glm::vec3(0.0f);
-                end_game(false);
-            }
-        }
+        simulate_step();
+        g_clock.end_step();
+    }
 
-        // check for successful landing
-        if (g_gameState.player->m_collided_bottom) {
-            vel = glm::vec3(0.0f);
-            if (angle > 25 or angle < -25 or g_tooFast) {
-                end_game(false);
-            } else {
-                end_game(true);
-            }
-        }
+    //  STREAMING  //
+    // keep the terrain around the lander loaded, and everything else not
+    g_cameraX = get_camera_x(g_world.transforms.get(g_gameState.player).position.x);
+    if (g_terrain.update(g_cameraX)) refresh_streamed_world();
+}
 
-        // check if player is moving slow enough to land
-        float currentSpeed = glm::length(vel);
-        g_tooFast = currentSpeed >= SAFE_SPEED;
+void render_overlay_text(DrawList* list, const char* text, int line)
+{
+    // in the font's 16x16 grid of ASCII cells, lines counted down from the top of the screen
+    for (int i = 0; text[i] != '\0'; i++) {
+        if (text[i] == ' ') continue;
+        Transform2D transform = Transform2D::compose(
+            glm::vec2(-4.6f + i * OVERLAY_CHARACTER_WIDTH, 3.5f - line * OVERLAY_LINE_HEIGHT), 0.0f,
+            glm::vec2(OVERLAY_CHARACTER_SIZE));
+        int cell = (unsigned char)text[i];
+        list->add_sprite(g_letterTexture, transform,
+                         glm::vec4((cell % 16) / 16.0f, (cell / 16) / 16.0f, 1.0f / 16.0f, 1.0f / 16.0f));
+    }
+}
 
-        // move the player
-        g_gameState.player->set_position(pos);
-        g_gameState.player->set_velocity(vel);
-        g_gameState.player->update(FIXED_TIMESTEP, g_gameState.landingPads, LANDINGPAD_COUNT);
+void render_frame_times(DrawList* list)
+{
+    // the last few seconds of frame times
+    float p50, p95, p99;
+    Profiler::get_frame_percentiles(&p50, &p95, &p99);
+    char text[64];
+    snprintf(text, sizeof(text), "P50 %.1f P95 %.1f P99 %.1f MS", p50, p95, p99);
+    render_overlay_text(list, text, 0);
+}
 
-        // reposition the flame
-        glm::vec3 flameOffset = glm::vec3(
-            0.4f * cos(glm::radians(angle - 90)),
-            0.4f * sin(glm::radians(angle - 90)),
-            0.0f);
-        g_gameState.flame->set_position(g_gameState.player->get_position() + flameOffset);
-        g_gameState.flame->set_angle(angle);
-        g_gameState.flame->update(FIXED_TIMESTEP, NULL, 0);
+void render_gl_stats(DrawList* list)
+{
+    // the last frame the GL thread finished, so a frame or two behind this one
+    GLFrameStats stats = GLStats::get_last_frame();
+    char text[64];
+    snprintf(text, sizeof(text), "DRAWS %d VERTS %lld TEX %d", stats.draw_calls, (long long)stats.vertices, stats.texture_binds);
+    render_overlay_text(list, text, 1);
+    snprintf(text, sizeof(text), "PROG %d UNIF %d VAO %d ATTR %d", stats.program_binds, stats.uniform_uploads,
+             stats.vertex_array_binds, stats.attribute_toggles);
+    render_overlay_text(list, text, 2);
+    snprintf(text, sizeof(text), "TEXMEM %.2f MB", stats.texture_bytes / (1024.0 * 1024.0));
+    render_overlay_text(list, text, 3);
+}
 
-        // update the fuel counter
-        for (int i = 0; i < 4; i++) {
-            g_gameState.letters[8-i].m_animation_index = ( int(g_fuel) % int(pow(10,i+1)) ) / pow(10,i) + 48;
-        }
- 
-        // update time accumulator
-        g_timeAccumulator -= FIXED_TIMESTEP;
+void render_allocations(DrawList* list)
+{
+    char text[64];
+    snprintf(text, sizeof(text), "RUN ARENA PEAK %zu OF %zu BYTES", g_runArena.get_peak(), g_runArena.get_capacity());
+    render_overlay_text(list, text, 5);
+
+    if (!AllocationTracker::is_enabled()) {
+        render_overlay_text(list, "BUILD WITH KERBAL_TRACK_ALLOCATIONS", 4);
+        return;
     }
+
+    AllocationStats total = AllocationTracker::get_total();
+    snprintf(text, sizeof(text), "ALLOCS %lld LIVE %.2f MB PEAK %.2f MB", (long long)g_frameAllocations,
+             total.live_bytes / (1024.0 * 1024.0), total.peak_bytes / (1024.0 * 1024.0));
+    render_overlay_text(list, text, 4);
 }
 
-void render()
+void record_frame(DrawList* list)
 {
-    //  GENERAL  //
-    glClear(GL_COLOR_BUFFER_BIT);
+    PROFILE_ZONE("record_frame");
+
+    // everything visible as of the last step; render() and the benchmarks each give their own list
+    // the simulation is up to one step ahead of the clock; blend moving entities
+    // back by however much of that step hasn't actually elapsed yet
+    float alpha = g_clock.get_alpha();
+    const Interpolation& playerInterpolation = g_world.interpolations.get(g_gameState.player);
+    glm::vec2 playerPosition = g_world.transforms.get(g_gameState.player).position;
+    if (playerInterpolation.valid) playerPosition = glm::mix(playerInterpolation.previous_position, playerPosition, alpha);
+    list->camera_x = get_camera_x(playerPosition.x);
+
+    // only what moved since the last frame is recomposed
+    update_transforms(g_world, &g_jobs);
+    g_world.sprites.get(g_gameState.flame).visible = g_thrusterOn;
 
     //  BACKGROUND  //
-    g_gameState.background->render(&g_shaderProgram);
+    // the starfield and the HUD stay put on screen; only the world scrolls
+    list->set_space(SPACE_SCREEN);
+    render_sprites(g_world, list, LAYER_BACKGROUND, alpha);
+
+    list->set_space(SPACE_WORLD);
 
     //  FLAME  //
-    if (g_thrusterOn) g_gameState.flame->render(&g_shaderProgram);
+    render_sprites(g_world, list, LAYER_FLAME, alpha);
 
     //  PLAYER  //
-    g_gameState.player->render(&g_shaderProgram);
+    render_sprites(g_world, list, LAYER_PLAYER, alpha);
 
     //  LANDING PADS  //
-    for (int i = 0; i < LANDINGPAD_COUNT; i++) g_gameState.landingPads[i].render(&g_shaderProgram);
+    render_sprites(g_world, list, LAYER_PADS, alpha);
 
     //  TERRAIN  //
-    g_gameState.terrain->render(&g_shaderProgram);
+    g_terrain.render(list);
+
+    //  PARTICLES  //
+    g_particles.render(list);
 
     //  DISPLAY LETTERS  //
-    for (int i = 0; i < LETTER_COUNT; i++) g_gameState.letters[i].render(&g_shaderProgram);
+    list->set_space(SPACE_SCREEN);
+    render_sprites(g_world, list, LAYER_HUD, alpha);
 
     //  ENDING TEXT  //
-    if (g_showEndText) g_gameState.endText->render(&g_shaderProgram);
+    render_sprites(g_world, list, LAYER_OVERLAY, alpha);
+
+    //  OVERLAYS  //
+    if (g_showFrameTimes) render_frame_times(list);
+    if (g_showGLStats) render_gl_stats(list);
+    if (g_showAllocations) render_allocations(list);
+}
+
+void render()
+{
+    PROFILE_ZONE("render");
+    ALLOCATION_SCOPE(ALLOC_RENDERING);
+
+    // runs on the simulation thread and only records what to draw; submit_frame()
+    // does the drawing, on the GL thread
+    DrawList& list = g_renderThread.begin_frame();
+
+    // anything that changed on disk, for the GL thread to swap in before drawing
+    if (g_watchAssets) g_hotReloader.collect(&list);
+
+    record_frame(&list);
 
     //  GENERAL  //
-    SDL_GL_SwapWindow(g_displayWindow);
+    g_renderThread.publish();
+    g_framesPublished++;
+    if (g_headless and g_frameLimit > 0 and g_framesPublished >= g_frameLimit) g_gameIsRunning = false;
+}
+
+//  GL THREAD  //
+void acquire_gl_context() {
+    if (g_headless) g_headlessContext.make_current();
+    else SDL_GL_MakeCurrent(g_displayWindow, g_glContext);
+}
+
+void release_gl_context() {
+    if (g_headless) g_headlessContext.release();
+    else SDL_GL_MakeCurrent(g_displayWindow, NULL);
+}
+
+void draw_frame(const DrawList& list) {
+    PROFILE_ZONE("draw_frame");
+
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // textures for newly streamed terrain, before anything can draw with them
+    for (const TextureUpload& upload : list.uploads) upload_texture(upload.texture_id, upload.data);
+
+    // edited shaders; a failed build leaves the old program in place
+    for (const ShaderReload& reload : list.shader_reloads) {
+        if (reload.shader == SHADER_PARTICLES) {
+            g_particles.reload_shader(reload.vertex_source, reload.fragment_source);
+            g_quadMesh.bind();
+        }
+        else if (g_shaderProgram.reload(reload.vertex_source, reload.fragment_source)) {
+            g_shaderProgram.set_projection_matrix(g_projectionMatrix);
+        }
+    }
+
+    glm::mat4 worldViewMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(-list.camera_x, 0.0f, 0.0f));
+    DrawSpace space = SPACE_SCREEN;
+    g_shaderProgram.set_view_matrix(glm::mat4(1.0f));
+
+    for (const DrawCommand& command : list.commands) {
+        if (command.space != space) {
+            space = command.space;
+            g_shaderProgram.set_view_matrix(space == SPACE_WORLD ? worldViewMatrix : glm::mat4(1.0f));
+        }
+
+        if (command.type == DRAW_PARTICLES) {
+            g_particles.submit(list, g_projectionMatrix, space == SPACE_WORLD ? worldViewMatrix : glm::mat4(1.0f), PARTICLE_SIZE);
+            g_quadMesh.bind();
+            continue;
+        }
+
+        // the shared quad mesh is bound once for the whole frame; only uniforms change per draw
+        g_shaderProgram.set_model_transform(command.transform);
+        g_shaderProgram.set_tex_rect(command.tex_rect.x, command.tex_rect.y, command.tex_rect.z, command.tex_rect.w);
+        gl_bind_texture(GL_TEXTURE_2D, command.texture_id);
+        gl_draw_arrays(GL_TRIANGLES, 0, QuadMesh::VERTEX_COUNT);
+    }
+}
+
+void submit_frame(const DrawList& list) {
+    draw_frame(list);
+    GLStats::end_frame();
+
+    PROFILE_ZONE(g_headless ? "capture" : "SDL_GL_SwapWindow");
+    if (g_headless) g_frameRecorder.capture();
+    else SDL_GL_SwapWindow(g_displayWindow);
+
+    // with nothing read back, the driver queues frames up and draws dozens of them
+    // at once; timed replays wait for each, so every frame pays for its own
+    if (g_replayCorpusPath != NULL) glFinish();
+}
+
+void start_game_loop() {
+    // from here on only the render thread touches GL; headless runs keep it in
+    // lockstep so that every simulated frame is recorded
+    release_gl_context();
+    g_renderThread.start(acquire_gl_context, submit_frame, release_gl_context, g_headless);
+
+    // the clock starts with the game loop, so loading isn't owed to the simulation
+    g_clock.load(g_headless ? (TimeSource*)&g_virtualTime : &g_systemTime, FIXED_TIMESTEP_NS, g_maxStepsPerFrame);
+    g_lastEventTicks = SDL_GetTicks();
+    g_lastEventMs = 0;
+}
+
+void stop_game_loop() {
+    // every frame published so far is drawn before the render thread lets go
+    g_renderThread.stop();
+    acquire_gl_context();
 }
 
 void shutdown() { 
+    if (Profiler::is_enabled() and Profiler::write_chrome_trace(g_tracePath)) LOG("Trace written to " << g_tracePath);
+
+    if (g_telemetry.in_episode()) g_telemetry.end_episode(OUTCOME_ABANDONED, get_lander_state());
+    if (g_telemetry.is_enabled() and g_telemetry.cleanup()) {
+        LOG("Telemetry written to " << g_telemetryPath << " (" << g_telemetry.get_rows_written() << " rows)");
+    }
+
+    g_hotReloader.cleanup();
+    g_sequences.clear();
+    g_jobs.cleanup();
+    g_terrain.cleanup();
+    g_particles.cleanup();
+    g_quadMesh.cleanup();
+    if (g_headless) {
+        g_frameRecorder.cleanup();
+        g_headlessContext.cleanup();
+    }
     SDL_Quit();
-    delete[] g_gameState.background;
-    delete[] g_gameState.terrain;
-    delete[] g_gameState.player;
-    delete[] g_gameState.flame;
-    delete[] g_gameState.landingPads;
-    delete[] g_gameState.letters;
-    delete[] g_gameState.endText;
+    g_world.clear();
+    LOG("Run arena peak: " << g_runArena.get_peak() << " of " << g_runArena.get_capacity() << " bytes");
+    g_runArena.cleanup();
+    g_level.cleanup();
+    Profiler::cleanup();
+
+    // whatever is left now is only let go of as the process exits
+    AllocationTracker::report();
+}
+
+//  BENCHMARKS  //
+struct GroundBenchmark { float minX, maxX; glm::vec2 landerScale; };
+struct StepBenchmark { int steps; };
+
+int run_benchmarks()
+{
+    // runs on the loading thread, which keeps the GL context: nothing is presented,
+    // and every draw is waited for so that it is what gets timed
+    BenchmarkSuite suite;
+    suite.load();
+    suite.add_context("renderer", (const char*)glGetString(GL_RENDERER));
+    suite.add_context("threads", std::to_string(g_jobs.get_thread_count()));
+
+    //  ENGINE  //
+    run_system_benchmarks(suite, &g_jobs);
+
+    const LevelData& level = g_level.get();
+    const char* textures[] = { level.background_path, level.player_path, level.flame_path, level.landing_pad_path,
+                               LETTERSHEET_FILEPATH, VICTORY_FILEPATH, CRASHED_FILEPATH };
+    run_texture_benchmarks(suite, textures, sizeof(textures) / sizeof(textures[0]));
+
+    //  TERRAIN  //
+    GroundBenchmark ground;
+    g_terrain.get_resident_range(&ground.minX, &ground.maxX);
+    ground.landerScale = g_world.transforms.get(g_gameState.player).scale;
+    suite.run("get_ground_level", BENCHMARK_GROUND_QUERIES, [](void* data) {
+        GroundBenchmark* ground = (GroundBenchmark*)data;
+        for (int i = 0; i < BENCHMARK_GROUND_QUERIES; i++) {
+            get_ground_level(glm::mix(ground->minX, ground->maxX, (i + 0.5f) / BENCHMARK_GROUND_QUERIES));
+        }
+    }, &ground);
+    suite.run("get_resident_ground_level", BENCHMARK_GROUND_QUERIES, [](void* data) {
+        GroundBenchmark* ground = (GroundBenchmark*)data;
+        for (int i = 0; i < BENCHMARK_GROUND_QUERIES; i++) {
+            g_terrain.get_resident_ground_level(glm::mix(ground->minX, ground->maxX, (i + 0.5f) / BENCHMARK_GROUND_QUERIES));
+        }
+    }, &ground);
+    suite.run("resident_hull_hits_ground", BENCHMARK_GROUND_QUERIES, [](void* data) {
+        // skimming the surface at every angle, where the boxes cull the least
+        GroundBenchmark* ground = (GroundBenchmark*)data;
+        for (int i = 0; i < BENCHMARK_GROUND_QUERIES; i++) {
+            float x = glm::mix(ground->minX + 0.5f, ground->maxX - 0.5f, (i + 0.5f) / BENCHMARK_GROUND_QUERIES);
+            PlacedHull hull;
+            place_hull(g_landerHull, glm::vec2(x, g_terrain.get_resident_ground_level(x) + 0.2f), i * 15.0f, ground->landerScale, hull);
+            g_terrain.resident_hull_hits_ground(hull);
+        }
+    }, &ground);
+
+    //  GAME STEP  //
+    // the restart every BENCHMARK_RUN_STEPS is timed too, spread over that many steps
+    const char* stepNames[] = { "simulate_step_coasting", "simulate_step_thrusting" };
+    for (int thrust = 0; thrust < 2; thrust++) {
+        start_run();
+        g_inputState.held[INPUT_THRUST] = thrust == 1;
+        StepBenchmark step = { 0 };
+        suite.run(stepNames[thrust], 0, [](void* data) {
+            StepBenchmark* step = (StepBenchmark*)data;
+            if (++step->steps % BENCHMARK_RUN_STEPS == 0) start_run();
+            simulate_step();
+        }, &step);
+    }
+    g_inputState.held[INPUT_THRUST] = false;
+
+    //  RENDERING  //
+    // mid-flight, exhaust and all; the first draw runs the terrain's texture uploads
+    DrawList list;
+    record_frame(&list);
+    draw_frame(list);
+    list.uploads.clear();
+
+    // what one frame costs the driver, for the results to be compared on as well as times
+    GLStats::end_frame();
+    draw_frame(list);
+    GLStats::end_frame();
+    GLFrameStats frameStats = GLStats::get_last_frame();
+    suite.add_context("frame draw calls", std::to_string(frameStats.draw_calls));
+    suite.add_context("frame vertices", std::to_string(frameStats.vertices));
+    suite.add_context("frame program binds", std::to_string(frameStats.program_binds));
+    suite.add_context("frame texture binds", std::to_string(frameStats.texture_binds));
+    suite.add_context("frame vertex array binds", std::to_string(frameStats.vertex_array_binds));
+    suite.add_context("frame uniform uploads", std::to_string(frameStats.uniform_uploads));
+    suite.add_context("frame attribute toggles", std::to_string(frameStats.attribute_toggles));
+    suite.add_context("texture bytes", std::to_string(frameStats.texture_bytes));
+
+    suite.run("record_frame", 0, [](void* data) {
+        DrawList* list = (DrawList*)data;
+        list->commands.clear();
+        list->particle_count = 0;
+        record_frame(list);
+    }, &list);
+    suite.run("draw_frame", list.particle_count, [](void* data) {
+        draw_frame(*(DrawList*)data);
+        glFinish();
+    }, &list);
+
+    // font cells drawn one quad each, like the HUD
+    const int spriteCounts[] = { 64, 1024, 8192 };
+    for (int spriteCount : spriteCounts) {
+        DrawList sprites;
+        for (int i = 0; i < spriteCount; i++) {
+            Transform2D transform = Transform2D::compose(
+                glm::vec2(-4.8f + (i % 48) * 0.2f, -3.6f + (i / 48 % 36) * 0.2f), 0.0f, glm::vec2(0.2f));
+            int cell = 33 + i % 94;
+            sprites.add_sprite(g_letterTexture, transform,
+                               glm::vec4((cell % 16) / 16.0f, (cell / 16) / 16.0f, 1.0f / 16.0f, 1.0f / 16.0f));
+        }
+        suite.run("draw_sprites", spriteCount, [](void* data) {
+            draw_frame(*(DrawList*)data);
+            glFinish();
+        }, &sprites);
+    }
+
+    //  RESULTS  //
+    suite.print();
+    if (!suite.write_json(g_benchmarkPath)) return 1;
+    LOG("Benchmark results written to " << g_benchmarkPath);
+    return 0;
+}
+
+//  REPLAYS  //
+void start_replay()
+{
+    // a fresh run on a fresh clock, with nothing left over from the last session
+    g_framesPublished = 0;
+    g_gameIsRunning = true;
+    g_inputState = InputState();
+    InputEvent stale;
+    while (g_inputRing.pop_before(UINT64_MAX, &stale)) {}
+    start_run();
+    start_game_loop();
+}
+
+int run_training()
+{
+    // the game loop and nothing else, as fast as it goes: a build instrumented for
+    // profile-guided optimisation learns from real sessions rather than someone at
+    // the keyboard, and writes its profile as the process exits
+    std::vector<std::string> sessions;
+    if (!read_session_list(g_trainingCorpusPath, sessions)) return 1;
+
+    for (const std::string& session : sessions) {
+        if (!g_session.load(session.c_str())) return 1;
+
+        start_replay();
+        while (g_gameIsRunning) {
+            process_input();
+            update();
+            render();
+        }
+        stop_game_loop();
+        LOG("Trained on " << session);
+    }
+    return 0;
+}
+
+int run_replay_suite()
+{
+    // each session gets a fresh run and a fresh clock, and the render thread is
+    // drained after it, so the draw calls counted are its own
+    std::vector<std::string> sessions;
+    if (!read_session_list(g_replayCorpusPath, sessions)) return 1;
+
+    ReplayReport report;
+    report.add_context("renderer", (const char*)glGetString(GL_RENDERER));
+    report.add_context("level", g_levelPath != NULL ? g_levelPath : "built in");
+    report.add_context("seed", std::to_string(g_terrainSeed));
+    report.add_context("threads", std::to_string(g_jobs.get_thread_count()));
+    report.add_context("allocation tracking", AllocationTracker::is_enabled() ? "on" : "off");
+
+    SystemTimeSource stopwatch;
+    stopwatch.reset();
+    for (const std::string& session : sessions) {
+        if (!g_session.load(session.c_str())) return 1;
+
+        start_replay();
+        int64_t drawCallsBefore = GLStats::get_totals().draw_calls;
+        AllocationTracker::end_frame();
+
+        std::vector<double> frameMs;
+        int64_t allocations = 0;
+        while (g_gameIsRunning) {
+            uint64_t frameStart = stopwatch.get_time_ns();
+            process_input();
+            update();
+            render();
+            frameMs.push_back((double)(stopwatch.get_time_ns() - frameStart) / NANOSECONDS_IN_MILLISECOND);
+            allocations += AllocationTracker::end_frame();
+        }
+
+        stop_game_loop();
+        report.add(session, frameMs, GLStats::get_totals().draw_calls - drawCallsBefore, allocations);
+        LOG("Replayed " << session);
+    }
+
+    //  RESULTS  //
+    report.print();
+    if (!report.write_json(g_replayResultsPath)) return 1;
+    LOG("Replay results written to " << g_replayResultsPath);
+    if (g_replayBaselinePath == NULL) return 0;
+
+    ReplayReport baseline;
+    if (!baseline.read_json(g_replayBaselinePath)) return 1;
+    int sessionCount;
+    int regressions = report.compare(baseline, &sessionCount);
+    LOG(regressions << " of " << sessionCount << " sessions regressed or went missing against " << g_replayBaselinePath);
+    return regressions > 0 ? 1 : 0;
 }
 
 // DRIVER GAME LOOP  /
 int main(int argc, char* argv[])
 {
+    // usage: kerbal-landing [--headless <output>] [--format raw|y4m|png] [--frames <count>]
+    //                       [--seed <n>] [--terrain-cache <directory>|none] [--terrain-images]
+    //                       [--level <file>] [--jobs <worker threads>] [--watch] [--max-steps <n>]
+    //                       [--profile <trace.json>] [--frame-times] [--gl-stats] [--allocations]
+    //                       [--record-input <session>] [--replay <session>] [--telemetry <file>]
+    //        kerbal-landing --benchmark <results.json> [--level <file>] [--jobs <worker threads>] ...
+    //        kerbal-landing --replay-suite <corpus> <results.json> [--baseline <results.json>] [--level <file>] ...
+    //        kerbal-landing --train [<corpus>] [--level <file>] ...
+    //        kerbal-landing --compile-level <text level> <compiled level>
+    bool seedGiven = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0 and i + 1 < argc) {
+            g_headless = true;
+            g_videoPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--format") == 0 and i + 1 < argc) {
+            if (!parse_frame_sink_format(argv[++i], &g_videoFormat)) {
+                LOG("Unknown video format: " << argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--frames") == 0 and i + 1 < argc) {
+            g_frameLimit = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 and i + 1 < argc) {
+            g_terrainSeed = (uint32_t)strtoul(argv[++i], NULL, 10);
+            seedGiven = true;
+        }
+        else if (strcmp(argv[i], "--terrain-cache") == 0 and i + 1 < argc) {
+            g_terrainCacheDirectory = strcmp(argv[++i], "none") == 0 ? NULL : argv[i];
+        }
+        else if (strcmp(argv[i], "--terrain-images") == 0) {
+            g_authoredTerrainMode = true;
+        }
+        else if (strcmp(argv[i], "--jobs") == 0 and i + 1 < argc) {
+            g_jobThreadCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max-steps") == 0 and i + 1 < argc) {
+            g_maxStepsPerFrame = atoi(argv[++i]);
+            if (g_maxStepsPerFrame < 1) {
+                LOG("--max-steps must be at least 1.");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--benchmark") == 0 and i + 1 < argc) {
+            // offscreen, but with nothing recorded
+            g_benchmarkPath = argv[++i];
+            g_headless = true;
+        }
+        else if (strcmp(argv[i], "--watch") == 0) {
+            g_watchAssets = true;
+        }
+        else if (strcmp(argv[i], "--record-input") == 0 and i + 1 < argc) {
+            g_recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 and i + 1 < argc) {
+            // offscreen; into a video too if --headless names one
+            if (!g_session.load(argv[++i])) return 1;
+            g_replaying = true;
+            g_headless = true;
+        }
+        else if (strcmp(argv[i], "--replay-suite") == 0 and i + 2 < argc) {
+            g_replayCorpusPath = argv[++i];
+            g_replayResultsPath = argv[++i];
+            g_replaying = true;
+            g_headless = true;
+        }
+        else if (strcmp(argv[i], "--train") == 0) {
+            bool corpusGiven = i + 1 < argc and strncmp(argv[i + 1], "--", 2) != 0;
+            g_trainingCorpusPath = corpusGiven ? argv[++i] : TRAINING_CORPUS_FILEPATH;
+            g_replaying = true;
+            g_headless = true;
+        }
+        else if (strcmp(argv[i], "--baseline") == 0 and i + 1 < argc) {
+            g_replayBaselinePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--telemetry") == 0 and i + 1 < argc) {
+            g_telemetryPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--profile") == 0 and i + 1 < argc) {
+            // from the start, rather than from the first F2
+            g_tracePath = argv[++i];
+            Profiler::set_enabled(true);
+        }
+        else if (strcmp(argv[i], "--frame-times") == 0) {
+            g_showFrameTimes = true;
+        }
+        else if (strcmp(argv[i], "--gl-stats") == 0) {
+            g_showGLStats = true;
+        }
+        else if (strcmp(argv[i], "--allocations") == 0) {
+            g_showAllocations = true;
+        }
+        else if (strcmp(argv[i], "--level") == 0 and i + 1 < argc) {
+            g_levelPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--compile-level") == 0 and i + 2 < argc) {
+            // nothing else happens in this mode
+            bool compiled = Level::compile(argv[i + 1], argv[i + 2]);
+            if (compiled) LOG("Compiled " << argv[i + 1] << " to " << argv[i + 2]);
+            return compiled ? 0 : 1;
+        }
+        else {
+            LOG("Unknown argument: " << argv[i]);
+            return 1;
+        }
+    }
+
+    if (g_levelPath != NULL and !g_level.load(g_levelPath)) {
+        LOG("Unable to load level: " << g_levelPath);
+        return 1;
+    }
+    if (!seedGiven) g_terrainSeed = g_level.get().seed;
+    if (g_level.get().terrain == LEVEL_TERRAIN_IMAGES) g_authoredTerrainMode = true;
+
+    // open before the first run starts, which is in initialise()
+    if (g_telemetryPath != NULL and !g_telemetry.load(g_telemetryPath)) return 1;
+
+    Profiler::set_thread_name("simulation");
     initialise();
 
+    if (g_benchmarkPath != NULL) {
+        int result = run_benchmarks();
+        shutdown();
+        return result;
+    }
+
+    if (g_replayCorpusPath != NULL) {
+        int result = run_replay_suite();
+        shutdown();
+        return result;
+    }
+
+    if (g_trainingCorpusPath != NULL) {
+        int result = run_training();
+        shutdown();
+        return result;
+    }
+
+    start_game_loop();
     while (g_gameIsRunning)
     {
+        Profiler::mark_frame();
+        g_frameAllocations = AllocationTracker::end_frame();
+        PROFILE_ZONE("frame");
         process_input();
         update();
         render();
     }
 
+    stop_game_loop();
+
+    if (g_recordPath != NULL) {
+        g_session.record(get_event_time_ns(SDL_GetTicks()), SESSION_END);
+        if (g_session.save(g_recordPath)) LOG("Input session written to " << g_recordPath);
+    }
+
     shutdown();
     return 0;
 }
\ No newline at end of file
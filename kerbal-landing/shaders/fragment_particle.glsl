@@ -0,0 +1,13 @@
+
+in float lifeVar;
+in float tintVar;
+
+out vec4 fragColor;
+
+void main() {
+    // round, soft-edged points that cool from flame orange to smoke grey as they age
+    float falloff = 1.0 - smoothstep(0.25, 0.5, length(gl_PointCoord - vec2(0.5)));
+    vec3 exhaust = mix(vec3(0.55, 0.55, 0.6), vec3(1.0, 0.75, 0.25), lifeVar);
+    vec3 debris = vec3(0.75, 0.78, 0.72);
+    fragColor = vec4(mix(exhaust, debris, tintVar), lifeVar * falloff);
+}
@@ -1,11 +1,12 @@
-attribute vec4 position;
+in vec4 position;
 
-uniform mat4 modelMatrix;
+uniform vec3 modelTransform[2];  // rows of a 2D affine transform
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 
 void main()
 {
-	vec4 p = viewMatrix * modelMatrix  * position;
+	vec3 local = vec3(position.xy, 1.0);
+	vec4 p = viewMatrix * vec4(dot(modelTransform[0], local), dot(modelTransform[1], local), 0.0, 1.0);
 	gl_Position = projectionMatrix * p;
 }
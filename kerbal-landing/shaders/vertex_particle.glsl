@@ -0,0 +1,19 @@
+in float particleX;
+in float particleY;
+in float life;
+in float tint;
+
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+uniform float pointSize;
+
+out float lifeVar;
+out float tintVar;
+
+void main()
+{
+	lifeVar = life;
+	tintVar = tint;
+	gl_PointSize = pointSize * (0.5 + 0.5 * life);
+	gl_Position = projectionMatrix * viewMatrix * vec4(particleX, particleY, 0.0, 1.0);
+}
@@ -1,15 +1,17 @@
-attribute vec4 position;
-attribute vec2 texCoord;
+in vec4 position;
+in vec2 texCoord;
 
-uniform mat4 modelMatrix;
+uniform vec3 modelTransform[2];  // rows of a 2D affine transform
+uniform vec4 texRect;            // atlas cell: uv offset in xy, uv size in zw
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 
-varying vec2 texCoordVar;
+out vec2 texCoordVar;
 
 void main()
 {
-	vec4 p = viewMatrix * modelMatrix  * position;
-    texCoordVar = texCoord;
+	vec3 local = vec3(position.xy, 1.0);
+	vec4 p = viewMatrix * vec4(dot(modelTransform[0], local), dot(modelTransform[1], local), 0.0, 1.0);
+    texCoordVar = texRect.xy + texCoord * texRect.zw;
 	gl_Position = projectionMatrix * p;
 }
\ No newline at end of file